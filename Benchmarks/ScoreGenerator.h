@@ -0,0 +1,105 @@
+#pragma once
+#include "Constants.h"
+#include "Score.h"
+#include <algorithm>
+#include <random>
+
+namespace MikuMikuWorld
+{
+	struct ScoreGeneratorOptions
+	{
+		int taps{ 40000 };
+		int holds{ 10000 };
+		// Steps of every hold between its start and end
+		int steps{ 4 };
+		int damages{ 1000 };
+		int hiSpeeds{ 200 };
+		unsigned int seed{ 1 };
+	};
+
+	/**
+	 * @brief Generates a chart with the requested number of notes and events
+	 * @note Notes are spread over the chart in tick order. Every value comes from a random
+	 *       generator seeded with `options.seed`, so runs with the same options produce the same
+	 *       chart
+	 */
+	inline Score generateScore(const ScoreGeneratorOptions& options)
+	{
+		Score score;
+		std::mt19937 random(options.seed);
+		std::uniform_int_distribution<int> widths(MIN_NOTE_WIDTH, 4);
+		std::uniform_int_distribution<int> flicks(0, (int)FlickType::FlickTypeCount - 1);
+		std::bernoulli_distribution rarely(0.1);
+
+		auto makeNote = [&](NoteType type, int tick)
+		{
+			const int width = widths(random);
+			Note note(type, nextID++, tick,
+			          std::uniform_int_distribution<int>(MIN_LANE, MAX_LANE - width + 1)(random),
+			          width);
+			note.critical = rarely(random);
+			return note;
+		};
+
+		// Sixteenth notes of every kind share the same timeline
+		constexpr int interval = TICKS_PER_BEAT / 4;
+		const int holdLength = (options.steps + 1) * interval;
+		for (int i = 0; i < options.taps; ++i)
+		{
+			Note note = makeNote(NoteType::Tap, i * interval);
+			note.friction = rarely(random);
+			if (rarely(random))
+				note.flick = (FlickType)flicks(random);
+
+			score.notes[note.ID] = note;
+		}
+
+		const int holdSpacing = options.taps / std::max(options.holds, 1) * interval + interval;
+		for (int i = 0; i < options.holds; ++i)
+		{
+			const int tick = i * holdSpacing;
+			Note start = makeNote(NoteType::Hold, tick);
+			score.notes[start.ID] = start;
+
+			HoldNote hold;
+			hold.start = HoldStep{ start.ID, HoldStepType::Normal, EaseType::Linear };
+			for (int step = 1; step <= options.steps; ++step)
+			{
+				Note mid = makeNote(NoteType::HoldMid, tick + step * interval);
+				mid.parentID = start.ID;
+				score.notes[mid.ID] = mid;
+
+				const HoldStepType type =
+				    rarely(random) ? HoldStepType::Hidden : HoldStepType::Normal;
+				hold.steps.push_back(HoldStep{ mid.ID, type, EaseType::Linear });
+			}
+
+			Note end = makeNote(NoteType::HoldEnd, tick + holdLength);
+			end.parentID = start.ID;
+			if (rarely(random))
+				end.flick = FlickType::Default;
+
+			score.notes[end.ID] = end;
+			hold.end = end.ID;
+			score.holdNotes[start.ID] = hold;
+		}
+
+		for (int i = 0; i < options.damages; ++i)
+		{
+			Note note = makeNote(NoteType::Damage, i * interval * 7);
+			note.critical = false;
+			score.notes[note.ID] = note;
+		}
+
+		const int chartLength = std::max(options.taps, 1) * interval;
+		for (int i = 0; i < options.hiSpeeds; ++i)
+		{
+			const int id = nextHiSpeedID++;
+			const float speed = std::uniform_real_distribution<float>(0.5f, 2.0f)(random);
+			score.hiSpeedChanges[id] =
+			    HiSpeedChange{ id, chartLength / (options.hiSpeeds + 1) * (i + 1), speed };
+		}
+
+		return score;
+	}
+}
@@ -0,0 +1,404 @@
+// Measures throughput and peak heap usage of loading, saving and converting scores.
+// Usage: ScoreIOBenchmark [options], see printUsage
+#include "File.h"
+#include "SUS.h"
+#include "ScoreConverter.h"
+#include "ScoreGenerator.h"
+#include "Sonolus_json.h"
+#include "Stopwatch.h"
+#include "SusExporter.h"
+#include "SusParser.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <new>
+
+using namespace MikuMikuWorld;
+namespace fs = std::filesystem;
+
+namespace
+{
+	// Heap usage of the whole program, tracked by the allocation functions below
+	std::atomic<size_t> heapUsage{};
+	std::atomic<size_t> heapPeak{};
+
+	// Keeps allocations aligned for every fundamental type
+	constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+}
+
+void* operator new(size_t size)
+{
+	void* memory = std::malloc(size + ALLOCATION_HEADER);
+	if (!memory)
+		throw std::bad_alloc();
+
+	*static_cast<size_t*>(memory) = size;
+	const size_t usage = heapUsage += size;
+	size_t peak = heapPeak;
+	while (usage > peak && !heapPeak.compare_exchange_weak(peak, usage))
+		;
+
+	return static_cast<char*>(memory) + ALLOCATION_HEADER;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	if (!pointer)
+		return;
+
+	void* memory = static_cast<char*>(pointer) - ALLOCATION_HEADER;
+	heapUsage -= *static_cast<size_t*>(memory);
+	std::free(memory);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { operator delete(pointer); }
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		ScoreGeneratorOptions generator{};
+		int iterations{ 5 };
+		bool csv{ false };
+		fs::path directory{ fs::temp_directory_path() / "mmw_benchmark" };
+	};
+
+	struct BenchmarkResult
+	{
+		std::string name;
+		double seconds{};
+		size_t bytes{};
+		size_t peakHeap{};
+	};
+
+	void printUsage()
+	{
+		printf("Usage: ScoreIOBenchmark [options]\n"
+		       "Options:\n"
+		       "  --taps <n>        tap notes (default 40000)\n"
+		       "  --holds <n>       holds (default 10000)\n"
+		       "  --steps <n>       steps per hold (default 4)\n"
+		       "  --damages <n>     damage notes (default 1000)\n"
+		       "  --hispeeds <n>    hi-speed changes (default 200)\n"
+		       "  --seed <n>        seed of the chart generator (default 1)\n"
+		       "  --iterations <n>  runs of each path, the fastest is reported (default 5)\n"
+		       "  --dir <path>      directory for the generated files\n"
+		       "  --csv             print comma separated values\n");
+	}
+
+	bool parseOptions(int argc, char** argv, BenchmarkOptions& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			auto value = [&]() { return std::max(std::atoi(argv[++i]), 0); };
+
+			if (arg == "--taps" && hasValue)
+				options.generator.taps = value();
+			else if (arg == "--holds" && hasValue)
+				options.generator.holds = value();
+			else if (arg == "--steps" && hasValue)
+				options.generator.steps = value();
+			else if (arg == "--damages" && hasValue)
+				options.generator.damages = value();
+			else if (arg == "--hispeeds" && hasValue)
+				options.generator.hiSpeeds = value();
+			else if (arg == "--seed" && hasValue)
+				options.generator.seed = value();
+			else if (arg == "--iterations" && hasValue)
+				options.iterations = std::max(value(), 1);
+			else if (arg == "--dir" && hasValue)
+				options.directory = fs::u8path(argv[++i]);
+			else if (arg == "--csv")
+				options.csv = true;
+			else
+				return false;
+		}
+
+		return true;
+	}
+
+	size_t getFileSize(const fs::path& path)
+	{
+		std::error_code error;
+		const uintmax_t size = fs::file_size(path, error);
+		return error ? 0 : size;
+	}
+
+	void writeText(const fs::path& path, const std::string& text)
+	{
+		std::unique_ptr<FILE, decltype(&fclose)> file(
+		    IO::File::openStream(path.u8string(), "w"), &fclose);
+		if (!file || fwrite(text.data(), 1, text.size(), file.get()) != text.size())
+			throw std::runtime_error("Failed to write " + path.u8string());
+	}
+
+	nlohmann::json readJson(const fs::path& path)
+	{
+		std::unique_ptr<FILE, decltype(&fclose)> file(
+		    IO::File::openStream(path.u8string(), "r"), &fclose);
+		if (!file)
+			throw std::runtime_error("Failed to open " + path.u8string());
+
+		return nlohmann::json::parse(file.get());
+	}
+
+	// Builds a Sonolus level with the notes of the score, there is no exporter for the format
+	nlohmann::json toSonolusLevel(const Score& score)
+	{
+		using nlohmann::json;
+		auto makeEntity = [](const char* archetype, std::string name, json data)
+		{
+			json entity{ { "archetype", archetype }, { "data", std::move(data) } };
+			if (!name.empty())
+				entity["name"] = std::move(name);
+
+			return entity;
+		};
+
+		auto noteData = [](const Note& note)
+		{
+			const double beat = (double)note.tick / TICKS_PER_BEAT;
+			const double size = note.width / 2.0;
+			return json::array({ { { "name", "#BEAT" }, { "value", beat } },
+			                     { { "name", "lane" }, { "value", note.lane + size - 6 } },
+			                     { { "name", "size" }, { "value", size } },
+			                     { { "name", "timeScaleGroup" }, { "ref", "tsg:0" } } });
+		};
+
+		auto noteName = [](int id) { return "n" + std::to_string(id); };
+
+		json entities = json::array();
+		entities.push_back(makeEntity("Initialization", "", json::array()));
+		entities.push_back(makeEntity("TimeScaleGroup", "tsg:0", json::array()));
+		for (const Tempo& tempo : score.tempoChanges)
+		{
+			const double beat = (double)tempo.tick / TICKS_PER_BEAT;
+			entities.push_back(makeEntity(
+			    "#BPM_CHANGE", "",
+			    json::array({ { { "name", "#BEAT" }, { "value", beat } },
+			                  { { "name", "#BPM" }, { "value", tempo.bpm } } })));
+		}
+
+		int hiSpeedIndex = 0;
+		for (const auto& [id, hiSpeed] : score.hiSpeedChanges)
+		{
+			const double beat = (double)hiSpeed.tick / TICKS_PER_BEAT;
+			entities.push_back(makeEntity(
+			    "TimeScaleChange", "tsc:0:" + std::to_string(hiSpeedIndex++),
+			    json::array({ { { "name", "#BEAT" }, { "value", beat } },
+			                  { { "name", "timeScale" }, { "value", hiSpeed.speed } } })));
+		}
+
+		for (const auto& [id, note] : score.notes)
+		{
+			if (note.getType() != NoteType::Tap && note.getType() != NoteType::Damage)
+				continue;
+
+			const char* archetype = note.getType() == NoteType::Damage ? "DamageNote"
+			                        : note.critical                    ? "CriticalTapNote"
+			                                                           : "NormalTapNote";
+			entities.push_back(makeEntity(archetype, noteName(id), noteData(note)));
+		}
+
+		for (const auto& [id, hold] : score.holdNotes)
+		{
+			const std::string start = noteName(hold.start.ID);
+			const std::string end = noteName(hold.end);
+			entities.push_back(
+			    makeEntity("NormalSlideStartNote", start, noteData(score.notes.at(hold.start.ID))));
+
+			for (const HoldStep& step : hold.steps)
+			{
+				json data = noteData(score.notes.at(step.ID));
+				data.push_back({ { "name", "start" }, { "ref", start } });
+				entities.push_back(makeEntity("NormalSlideTickNote", noteName(step.ID), data));
+			}
+
+			entities.push_back(
+			    makeEntity("NormalSlideEndNote", end, noteData(score.notes.at(hold.end))));
+
+			// Connectors between every pair of consecutive notes provide the eases
+			auto stepID = [&hold](int i)
+			{
+				if (i < 0)
+					return hold.start.ID;
+
+				return i < (int)hold.steps.size() ? hold.steps[i].ID : hold.end;
+			};
+
+			for (int i = -1; i < (int)hold.steps.size(); ++i)
+			{
+				entities.push_back(makeEntity(
+				    "NormalSlideConnector", "",
+				    json::array({ { { "name", "head" }, { "ref", noteName(stepID(i)) } },
+				                  { { "name", "tail" }, { "ref", noteName(stepID(i + 1)) } },
+				                  { { "name", "start" }, { "ref", start } },
+				                  { { "name", "end" }, { "ref", end } },
+				                  { { "name", "ease" }, { "value", 0 } } })));
+			}
+		}
+
+		return json{ { "bgmOffset", 0 }, { "entities", std::move(entities) } };
+	}
+
+	/**
+	 * @brief Runs `function` the requested number of times and keeps the fastest run
+	 * @param function Returns the number of bytes read or written by the run
+	 */
+	BenchmarkResult measure(const std::string& name, int iterations,
+	                        const std::function<size_t()>& function)
+	{
+		BenchmarkResult result{ name, std::numeric_limits<double>::max() };
+		for (int i = 0; i < iterations; ++i)
+		{
+			const size_t baseline = heapUsage;
+			heapPeak = baseline;
+
+			Stopwatch stopwatch;
+			result.bytes = function();
+			result.seconds = std::min(result.seconds, stopwatch.elapsed());
+			result.peakHeap = std::max(result.peakHeap, heapPeak - baseline);
+		}
+
+		return result;
+	}
+
+	void printResults(const std::vector<BenchmarkResult>& results, size_t noteCount, bool csv)
+	{
+		constexpr double megabyte = 1024.0 * 1024.0;
+		if (csv)
+			printf("path,notes,ms,notes_per_s,mb_per_s,peak_heap_mb\n");
+		else
+			printf("%-24s %10s %14s %10s %14s\n", "path", "ms", "notes/s", "MB/s", "peak heap MB");
+
+		for (const BenchmarkResult& result : results)
+		{
+			const double notesPerSecond = noteCount / result.seconds;
+			const double megabytesPerSecond = result.bytes / megabyte / result.seconds;
+			const double peakHeap = result.peakHeap / megabyte;
+			if (csv)
+				printf("%s,%zu,%.3f,%.0f,%.2f,%.2f\n", result.name.c_str(), noteCount,
+				       result.seconds * 1000.0, notesPerSecond, megabytesPerSecond, peakHeap);
+			else
+				printf("%-24s %10.3f %14.0f %10.2f %14.2f\n", result.name.c_str(),
+				       result.seconds * 1000.0, notesPerSecond, megabytesPerSecond, peakHeap);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	fs::create_directories(options.directory);
+	const fs::path mmwsPath = options.directory / "benchmark.mmws";
+	const fs::path compactPath = options.directory / "benchmark_compact.mmws";
+	const fs::path uscPath = options.directory / "benchmark.usc";
+	const fs::path susPath = options.directory / "benchmark.sus";
+	const fs::path sonolusPath = options.directory / "benchmark.json";
+
+	const Score score = generateScore(options.generator);
+	const size_t noteCount = score.notes.size();
+	writeText(sonolusPath, toSonolusLevel(score).dump());
+
+	const int iterations = options.iterations;
+	std::vector<BenchmarkResult> results;
+	try
+	{
+		auto mmwsSave = [&]()
+		{
+			serializeScore(score, mmwsPath.u8string());
+			return getFileSize(mmwsPath);
+		};
+		results.push_back(measure("mmws save", iterations, mmwsSave));
+
+		auto mmwsLoad = [&]()
+		{
+			resetNextID();
+			Score loaded = deserializeScore(mmwsPath.u8string());
+			return getFileSize(mmwsPath);
+		};
+		results.push_back(measure("mmws load", iterations, mmwsLoad));
+
+		auto mmwsCompactSave = [&]()
+		{
+			serializeScore(score, compactPath.u8string(), true);
+			return getFileSize(compactPath);
+		};
+		results.push_back(measure("mmws compact save", iterations, mmwsCompactSave));
+
+		auto mmwsCompactLoad = [&]()
+		{
+			resetNextID();
+			Score loaded = deserializeScore(compactPath.u8string());
+			return getFileSize(compactPath);
+		};
+		results.push_back(measure("mmws compact load", iterations, mmwsCompactLoad));
+
+		auto uscExport = [&]()
+		{
+			writeText(uscPath, ScoreConverter::scoreToUsc(score).dump());
+			return getFileSize(uscPath);
+		};
+		results.push_back(measure("usc export", iterations, uscExport));
+
+		auto uscImport = [&]()
+		{
+			resetNextID();
+			Score loaded = ScoreConverter::uscToScore(readJson(uscPath));
+			return getFileSize(uscPath);
+		};
+		results.push_back(measure("usc import", iterations, uscImport));
+
+		auto susExport = [&]()
+		{
+			SusExporter exporter;
+			exporter.dump(ScoreConverter::scoreToSus(score), susPath.u8string());
+			return getFileSize(susPath);
+		};
+		results.push_back(measure("sus export", iterations, susExport));
+
+		auto susImport = [&]()
+		{
+			resetNextID();
+			SusParser parser;
+			Score loaded = ScoreConverter::susToScore(parser.parse(susPath.u8string()));
+			return getFileSize(susPath);
+		};
+		results.push_back(measure("sus import", iterations, susImport));
+
+		auto sonolusJsonImport = [&]()
+		{
+			resetNextID();
+			Score loaded = Sonolus_json::load_file(sonolusPath.u8string());
+			return getFileSize(sonolusPath);
+		};
+		results.push_back(measure("sonolus json import", iterations, sonolusJsonImport));
+	}
+	catch (const std::exception& err)
+	{
+		fprintf(stderr, "Benchmark failed: %s\n", err.what());
+		return EXIT_FAILURE;
+	}
+
+	if (!options.csv)
+		printf("notes: %zu, holds: %zu, hi-speeds: %zu, iterations: %d\n", noteCount,
+		       score.holdNotes.size(), score.hiSpeedChanges.size(), iterations);
+
+	printResults(results, noteCount, options.csv);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+// Measures undo/redo latency of HistoryManager on a large synthetic chart.
+// Usage: UndoBenchmark [note count] [edit count]
+#include "Constants.h"
+#include "HistoryManager.h"
+#include "ScoreGenerator.h"
+#include "Stopwatch.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace MikuMikuWorld;
+
+namespace
+{
+	// Moves a random selection of notes by one beat, like dragging a selection in the timeline
+	void moveSelection(Score& score, const std::vector<int>& ids, int selectionSize,
+	                   std::mt19937& random)
+	{
+		std::uniform_int_distribution<size_t> pick(0, ids.size() - 1);
+		for (int i = 0; i < selectionSize; ++i)
+			score.notes.at(ids[pick(random)]).tick += TICKS_PER_BEAT;
+	}
+
+	void printUsage() { printf("Usage: UndoBenchmark [note count] [edit count]\n"); }
+
+	// Parses a positive count, rejecting anything that is not entirely a number
+	bool parseCount(const char* arg, int& count)
+	{
+		char* end;
+		const long value = std::strtol(arg, &end, 10);
+		if (end == arg || *end != '\0' || value < 1 || value > INT_MAX)
+			return false;
+
+		count = static_cast<int>(value);
+		return true;
+	}
+
+	double millisecondsPer(const Stopwatch& stopwatch, int count)
+	{
+		return stopwatch.elapsed() * 1000.0 / std::max(count, 1);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int noteCount = 100000;
+	int editCount = 200;
+	if (argc > 3 || (argc > 1 && !parseCount(argv[1], noteCount)) ||
+	    (argc > 2 && !parseCount(argv[2], editCount)))
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	constexpr int selectionSize = 64;
+
+	// One hold with four steps for every four taps
+	ScoreGeneratorOptions generatorOptions{};
+	generatorOptions.holds = noteCount / 10;
+	generatorOptions.taps = noteCount - generatorOptions.holds * 6;
+	generatorOptions.steps = 4;
+	generatorOptions.damages = 0;
+	generatorOptions.hiSpeeds = 0;
+
+	std::mt19937 random(1);
+	Score score = generateScore(generatorOptions);
+	std::vector<int> ids;
+	ids.reserve(score.notes.size());
+	for (const auto& [id, note] : score.notes)
+		ids.push_back(id);
+
+	HistoryManager history;
+	Stopwatch stopwatch;
+	for (int i = 0; i < editCount; ++i)
+	{
+		Score prev = score;
+		moveSelection(score, ids, selectionSize, random);
+		history.pushHistory("Update notes", prev, score);
+	}
+	const double pushTime = millisecondsPer(stopwatch, editCount);
+
+	stopwatch.reset();
+	while (history.hasUndo())
+		history.undo(score);
+	const double undoTime = millisecondsPer(stopwatch, editCount);
+
+	stopwatch.reset();
+	while (history.hasRedo())
+		history.redo(score);
+	const double redoTime = millisecondsPer(stopwatch, editCount);
+
+	printf("notes: %zu, holds: %zu, edits: %d x %d notes\n", score.notes.size(),
+	       score.holdNotes.size(), editCount, selectionSize);
+	printf("history memory: %.2f KB\n", history.getMemoryUsage() / 1024.0);
+	printf("edit + push: %.4f ms\n", pushTime);
+	printf("undo:        %.4f ms\n", undoTime);
+	printf("redo:        %.4f ms\n", redoTime);
+	return 0;
+}
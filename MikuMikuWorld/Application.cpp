@@ -3,6 +3,7 @@
 #include "Colors.h"
 #include "IO.h"
 #include "Localization.h"
+#include "Rendering/Renderer.h"
 #include "ResourceManager.h"
 #include "Utilities.h"
 #include <filesystem>
@@ -314,6 +315,13 @@ namespace MikuMikuWorld
 	void Application::loadResources()
 	{
 		ResourceManager::loadShader(appDir + "res\\shaders\\basic2d");
+
+		// Sprite batches bind their textures to consecutive texture units
+		Shader* basic2d = ResourceManager::shaders.back();
+		basic2d->use();
+		for (int i = 0; i < maxBatchTextures; ++i)
+			basic2d->setInt(IO::formatString("textures[%d]", i), i);
+
 		const std::string texturesDir = appDir + "res\\textures\\";
 		ResourceManager::loadTexture(texturesDir + "notes1.png",
 		                             TextureFilterMode::LinearMipMapLinear,
@@ -36,6 +36,7 @@ namespace MikuMikuWorld
 		{
 			minifyUsc = jsonIO::tryGetValue<bool>(config["file"], "minify_usc", true);
 			showSusExport = jsonIO::tryGetValue<bool>(config["file"], "show_sus_export", false);
+			compactScoreFiles = jsonIO::tryGetValue<bool>(config["file"], "compact_mmws", false);
 		}
 
 		if (jsonIO::keyExists(config, "window"))
@@ -107,6 +108,17 @@ namespace MikuMikuWorld
 			autoSaveEnabled = jsonIO::tryGetValue<bool>(config["save"], "auto_save_enabled", true);
 			autoSaveInterval = jsonIO::tryGetValue<int>(config["save"], "auto_save_interval", 5);
 			autoSaveMaxCount = jsonIO::tryGetValue<int>(config["save"], "auto_save_max_count", 100);
+			autoSaveJournal = jsonIO::tryGetValue<bool>(config["save"], "auto_save_journal", false);
+			autoSaveJournalCompactCount =
+			    jsonIO::tryGetValue<int>(config["save"], "auto_save_journal_compact_count", 30);
+		}
+
+		if (jsonIO::keyExists(config, "history"))
+		{
+			historyMemoryLimit =
+			    jsonIO::tryGetValue<int>(config["history"], "memory_limit_mb", 256);
+			mergeHistoryEntries =
+			    jsonIO::tryGetValue<bool>(config["history"], "merge_same_entries", false);
 		}
 
 		if (jsonIO::keyExists(config, "audio"))
@@ -157,6 +169,7 @@ namespace MikuMikuWorld
 		config["debug"] = debugEnabled;
 		config["file"]["minify_usc"] = minifyUsc;
 		config["file"]["show_sus_export"] = showSusExport;
+		config["file"]["compact_mmws"] = compactScoreFiles;
 		config["window"]["position"] = { { "x", windowPos.x }, { "y", windowPos.y } };
 
 		config["window"]["size"] = { { "x", windowSize.x }, { "y", windowSize.y } };
@@ -193,7 +206,12 @@ namespace MikuMikuWorld
 
 		config["save"] = { { "auto_save_enabled", autoSaveEnabled },
 			               { "auto_save_interval", autoSaveInterval },
-			               { "auto_save_max_count", autoSaveMaxCount } };
+			               { "auto_save_max_count", autoSaveMaxCount },
+			               { "auto_save_journal", autoSaveJournal },
+			               { "auto_save_journal_compact_count", autoSaveJournalCompactCount } };
+
+		config["history"] = { { "memory_limit_mb", historyMemoryLimit },
+			                  { "merge_same_entries", mergeHistoryEntries } };
 
 		config["audio"] = { { "se_profile", seProfileIndex },
 			                { "master_volume", masterVolume },
@@ -236,6 +254,7 @@ namespace MikuMikuWorld
 
 		minifyUsc = true;
 		showSusExport = false;
+		compactScoreFiles = false;
 		timelineWidth = 26;
 		notesHeight = 26;
 		matchNotesSizeToTimeline = true;
@@ -258,6 +277,11 @@ namespace MikuMikuWorld
 		autoSaveEnabled = true;
 		autoSaveInterval = 5;
 		autoSaveMaxCount = 100;
+		autoSaveJournal = false;
+		autoSaveJournalCompactCount = 30;
+
+		historyMemoryLimit = 256;
+		mergeHistoryEntries = false;
 
 		seProfileIndex = 0;
 		masterVolume = 1.0f;
@@ -98,6 +98,7 @@ namespace MikuMikuWorld
 		// settings
 		bool minifyUsc;
 		bool showSusExport;
+		bool compactScoreFiles;
 		int timelineWidth;
 		int notesHeight;
 		bool matchNotesSizeToTimeline;
@@ -117,6 +118,10 @@ namespace MikuMikuWorld
 		bool autoSaveEnabled;
 		int autoSaveInterval;
 		int autoSaveMaxCount;
+		bool autoSaveJournal;
+		int autoSaveJournalCompactCount;
+		int historyMemoryLimit;
+		bool mergeHistoryEntries;
 		float masterVolume;
 		float bgmVolume;
 		float seVolume;
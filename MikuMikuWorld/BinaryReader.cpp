@@ -1,104 +1,112 @@
 #include "BinaryReader.h"
+#include "File.h"
 #include "IO.h"
+#include <algorithm>
+#include <cstring>
 
 namespace IO
 {
-	BinaryReader::BinaryReader(const std::string& filename)
+	BinaryReader::BinaryReader(const std::string& filename, size_t maxSize)
 	{
-		stream = NULL;
-		std::wstring wFilename = mbToWideStr(filename);
-		stream = _wfopen(wFilename.c_str(), L"rb");
+		FILE* stream = File::openStream(filename, "rb");
+		if (!stream)
+			return;
+
+		// Load the file with a single read so decoding does not go through the C runtime
+		fseek(stream, 0, SEEK_END);
+		const long fileSize = ftell(stream);
+		fseek(stream, 0, SEEK_SET);
+
+		if (fileSize > 0)
+		{
+			const size_t size = std::min(static_cast<size_t>(fileSize), maxSize);
+			buffer.resize(size);
+			buffer.resize(fread(buffer.data(), sizeof(uint8_t), size, stream));
+		}
+
+		fclose(stream);
+		valid = true;
 	}
 
 	BinaryReader::~BinaryReader() { close(); }
 
-	bool BinaryReader::isStreamValid() { return stream; }
+	bool BinaryReader::isStreamValid() { return valid; }
 
 	void BinaryReader::close()
 	{
-		if (stream)
-			fclose(stream);
-
-		stream = NULL;
+		buffer.clear();
+		buffer.shrink_to_fit();
+		position = 0;
+		valid = false;
 	}
 
-	size_t BinaryReader::getFileSize()
-	{
-		size_t pos = ftell(stream);
-		fseek(stream, 0, SEEK_END);
+	size_t BinaryReader::getFileSize() { return buffer.size(); }
 
-		size_t size = ftell(stream);
-		fseek(stream, pos, SEEK_SET);
+	size_t BinaryReader::getStreamPosition() { return position; }
 
-		return size;
-	}
-
-	size_t BinaryReader::getStreamPosition() { return ftell(stream); }
-
-	uint16_t BinaryReader::readUInt16()
+	template <typename T> T BinaryReader::read()
 	{
-		uint16_t data = 0;
-		if (stream)
-			fread(&data, sizeof(uint16_t), 1, stream);
+		T data{};
+		if (position + sizeof(T) > buffer.size())
+		{
+			position = buffer.size();
+			return data;
+		}
 
+		memcpy(&data, buffer.data() + position, sizeof(T));
+		position += sizeof(T);
 		return data;
 	}
 
-	uint32_t BinaryReader::readUInt32()
-	{
-		uint32_t data = 0;
-		if (stream)
-			fread(&data, sizeof(uint32_t), 1, stream);
+	uint8_t BinaryReader::readUInt8() { return read<uint8_t>(); }
 
-		return data;
-	}
+	uint16_t BinaryReader::readUInt16() { return read<uint16_t>(); }
 
-	int16_t BinaryReader::readInt16()
-	{
-		int16_t data = 0;
-		if (stream)
-			fread(&data, sizeof(int16_t), 1, stream);
+	uint32_t BinaryReader::readUInt32() { return read<uint32_t>(); }
 
-		return data;
-	}
+	int16_t BinaryReader::readInt16() { return read<int16_t>(); }
 
-	int32_t BinaryReader::readInt32()
-	{
-		int32_t data = 0;
-		if (stream)
-			fread(&data, sizeof(int32_t), 1, stream);
+	int32_t BinaryReader::readInt32() { return read<int32_t>(); }
 
-		return data;
-	}
+	float BinaryReader::readSingle() { return read<float>(); }
 
-	float BinaryReader::readSingle()
+	std::string BinaryReader::readString()
 	{
-		float data = 0;
-		if (stream)
-			fread(&data, sizeof(float), 1, stream);
+		if (position >= buffer.size())
+			return "";
 
-		return data;
+		const char* begin = reinterpret_cast<const char*>(buffer.data() + position);
+		const size_t remaining = buffer.size() - position;
+		const size_t length = strnlen(begin, remaining);
+
+		// Skip the null terminator if the string has one
+		position += std::min(length + 1, remaining);
+		return std::string(begin, length);
 	}
 
-	std::string BinaryReader::readString()
+	uint32_t BinaryReader::readVarUInt32()
 	{
-		char c = 'a';
-		std::string data = "";
-		if (stream)
+		uint32_t data = 0;
+		for (int shift = 0; shift < 35 && position < buffer.size(); shift += 7)
 		{
-			while (c && !feof(stream))
-			{
-				fread(&c, sizeof(uint8_t), 1, stream);
-				if (c)
-					data += c;
-			}
+			uint8_t byte = buffer[position++];
+			data |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				break;
 		}
+
 		return data;
 	}
 
+	int32_t BinaryReader::readVarInt32()
+	{
+		uint32_t data = readVarUInt32();
+		return static_cast<int32_t>((data >> 1) ^ (~(data & 1) + 1));
+	}
+
 	void BinaryReader::seek(size_t pos)
 	{
-		if (stream)
-			fseek(stream, pos, SEEK_SET);
+		if (valid)
+			position = std::min(pos, buffer.size());
 	}
 }
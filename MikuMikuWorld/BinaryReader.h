@@ -1,16 +1,28 @@
 #pragma once
 #include <stdio.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace IO
 {
+	/**
+	 * @brief Reads binary data from a file that is loaded into memory once when opened
+	 * @note All reads are bounds checked against the loaded data. Reading past the end returns 0
+	 *       (or the characters read so far for strings) and leaves the position at the end
+	 */
 	class BinaryReader
 	{
 	  private:
-		FILE* stream;
+		std::vector<uint8_t> buffer;
+		size_t position{};
+		bool valid{ false };
+
+		template <typename T> T read();
 
 	  public:
-		BinaryReader(const std::string& filename);
+		// Loads at most `maxSize` bytes from the start of the file
+		BinaryReader(const std::string& filename, size_t maxSize = SIZE_MAX);
 		~BinaryReader();
 
 		bool isStreamValid();
@@ -20,11 +32,15 @@ namespace IO
 		size_t getStreamPosition();
 		void seek(size_t pos);
 
+		uint8_t readUInt8();
 		int16_t readInt16();
 		int32_t readInt32();
 		uint16_t readUInt16();
 		uint32_t readUInt32();
 		float readSingle();
 		std::string readString();
+		// LEB128 variable length integers, see `BinaryWriter::writeVarUInt32`
+		uint32_t readVarUInt32();
+		int32_t readVarInt32();
 	};
 }
@@ -1,89 +1,118 @@
 #include "BinaryWriter.h"
+#include "File.h"
 #include "IO.h"
+#include <cstring>
 
 namespace IO
 {
+	BinaryWriter::BinaryWriter() { stream = NULL; }
+
 	BinaryWriter::BinaryWriter(const std::string& filename)
+	    : filename{ filename }, tempFilename{ filename + ".tmp" }
 	{
-		stream = NULL;
-		std::wstring wFilename = mbToWideStr(filename);
-		stream = _wfopen(wFilename.c_str(), L"wb");
+		stream = File::openStream(tempFilename, "wb");
 	}
 
-	BinaryWriter::~BinaryWriter() { close(); }
+	BinaryWriter::~BinaryWriter() { discard(); }
 
 	bool BinaryWriter::isStreamValid() { return stream; }
 
-	void BinaryWriter::close()
+	bool BinaryWriter::close()
 	{
-		if (stream)
-			fclose(stream);
+		if (!stream)
+			return false;
+
+		const bool flushed = flush();
+		const bool closed = fclose(stream) == 0;
+		stream = NULL;
+
+		if (flushed && closed && File::replace(tempFilename, filename))
+			return true;
+
+		// Keep the previous file rather than replacing it with a partial one
+		File::remove(tempFilename);
+		return false;
 	}
 
-	void BinaryWriter::flush()
+	void BinaryWriter::discard()
 	{
-		if (stream)
-			fflush(stream);
+		if (!stream)
+			return;
+
+		fclose(stream);
+		stream = NULL;
+		File::remove(tempFilename);
 	}
 
-	size_t BinaryWriter::getFileSize()
+	bool BinaryWriter::flush()
 	{
-		size_t pos = ftell(stream);
-		fseek(stream, 0, SEEK_END);
-
-		size_t size = ftell(stream);
-		fseek(stream, pos, SEEK_SET);
+		if (!stream)
+			return false;
 
-		return size;
+		fseek(stream, 0, SEEK_SET);
+		const size_t written = fwrite(buffer.data(), sizeof(uint8_t), buffer.size(), stream);
+		return written == buffer.size() && fflush(stream) == 0 && !ferror(stream);
 	}
 
-	size_t BinaryWriter::getStreamPosition() { return ftell(stream); }
+	size_t BinaryWriter::getFileSize() { return buffer.size(); }
+
+	size_t BinaryWriter::getStreamPosition() { return position; }
 
-	void BinaryWriter::seek(size_t pos)
+	void BinaryWriter::seek(size_t pos) { position = pos; }
+
+	void BinaryWriter::write(const void* data, size_t size)
 	{
-		if (stream)
-			fseek(stream, pos, SEEK_SET);
+		if (position + size > buffer.size())
+			buffer.resize(position + size);
+
+		memcpy(buffer.data() + position, data, size);
+		position += size;
 	}
 
-	void BinaryWriter::writeInt16(uint16_t data)
+	void BinaryWriter::writeUInt8(uint8_t data) { write(&data, sizeof(uint8_t)); }
+
+	void BinaryWriter::writeInt16(uint16_t data) { write(&data, sizeof(uint16_t)); }
+
+	void BinaryWriter::writeInt32(uint32_t data) { write(&data, sizeof(uint32_t)); }
+
+	void BinaryWriter::writeSingle(float data) { write(&data, sizeof(float)); }
+
+	void BinaryWriter::writeNull(size_t length)
 	{
-		if (stream)
-			fwrite(&data, sizeof(uint16_t), 1, stream);
+		if (position + length > buffer.size())
+			buffer.resize(position + length);
+
+		memset(buffer.data() + position, 0, length);
+		position += length;
 	}
 
-	void BinaryWriter::writeInt32(uint32_t data)
+	void BinaryWriter::writeString(std::string data)
 	{
-		if (stream)
-			fwrite(&data, sizeof(uint32_t), 1, stream);
+		// Includes the null terminator
+		write(data.c_str(), data.size() + 1);
 	}
 
-	void BinaryWriter::writeSingle(float data)
+	void BinaryWriter::writeVarUInt32(uint32_t data)
 	{
-		if (stream)
-			fwrite(&data, sizeof(float), 1, stream);
+		while (data >= 0x80)
+		{
+			writeUInt8((data & 0x7F) | 0x80);
+			data >>= 7;
+		}
+
+		writeUInt8(data);
 	}
 
-	void BinaryWriter::writeNull(size_t length)
+	void BinaryWriter::writeVarInt32(int32_t data)
 	{
-		uint8_t zero = 0;
-		if (stream)
-			fwrite(&zero, sizeof(uint8_t), length, stream);
+		writeVarUInt32((static_cast<uint32_t>(data) << 1) ^ static_cast<uint32_t>(data >> 31));
 	}
 
-	void BinaryWriter::writeString(std::string data)
+	void BinaryWriter::writeInt32At(size_t pos, uint32_t data)
 	{
-		if (stream)
-		{
-			size_t length = data.size();
-			if (length)
-			{
-				fwrite(data.c_str(), sizeof(char), length, stream);
-				writeNull(1);
-			}
-			else
-			{
-				writeNull(1);
-			}
-		}
+		const size_t current = position;
+		position = pos;
+		writeInt32(data);
+		position = current;
 	}
 }
@@ -1,30 +1,59 @@
 #pragma once
 #include <stdio.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace IO
 {
+	/**
+	 * @brief Writes binary data to a memory buffer that is saved to the file when closed
+	 * @note The buffer is written in a single call to a temporary file next to the target, which
+	 *       then replaces the target. An interrupted save leaves the previous file intact.
+	 *       Only `close` replaces the target, a writer destroyed without it discards its data
+	 *       so an exception thrown while writing never commits a partial file
+	 */
 	class BinaryWriter
 	{
 	  private:
 		FILE* stream;
+		std::string filename;
+		std::string tempFilename;
+		std::vector<uint8_t> buffer;
+		size_t position{};
+
+		void write(const void* data, size_t size);
 
 	  public:
+		// Writes only to memory, the data is retrieved with `getBuffer`
+		BinaryWriter();
 		BinaryWriter(const std::string& filename);
 		~BinaryWriter();
 
 		bool isStreamValid();
-		void close();
-		void flush();
+		// Saves the buffer and moves it into place. Returns whether the file was written
+		bool close();
+		// Closes the temporary file and deletes it, leaving the target untouched
+		void discard();
+		// Writes the buffer to the temporary file without moving it into place
+		bool flush();
 
+		inline const std::vector<uint8_t>& getBuffer() const { return buffer; }
 		size_t getFileSize();
 		size_t getStreamPosition();
 
 		void seek(size_t pos);
+		void writeUInt8(uint8_t data);
 		void writeInt16(uint16_t data);
 		void writeInt32(uint32_t data);
 		void writeSingle(float data);
 		void writeString(std::string data);
 		void writeNull(size_t length);
+		// LEB128 variable length integers, signed values are zigzag encoded first
+		void writeVarUInt32(uint32_t data);
+		void writeVarInt32(int32_t data);
+
+		// Overwrites a value written earlier, such as a count or an offset, without seeking
+		void writeInt32At(size_t pos, uint32_t data);
 	};
 }
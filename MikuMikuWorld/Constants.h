@@ -28,5 +28,6 @@ namespace MikuMikuWorld
 	constexpr const char* USC_EXTENSION = ".usc";
 	constexpr const char* MMWS_EXTENSION = ".mmws";
 	constexpr const char* CC_MMWS_EXTENSION = ".ccmmws";
+	constexpr const char* MMWS_JOURNAL_EXTENSION = ".mmwj";
 	constexpr const char* JSON_EXTENSION	= ".json";
 }
@@ -0,0 +1,145 @@
+#pragma once
+#include <memory>
+#include <utility>
+
+namespace MikuMikuWorld
+{
+	/**
+	 * @brief Container wrapper whose copies share storage until one of them is modified
+	 * @note Copying is O(1). Any non-const access detaches the wrapper first by copying the
+	 *       container if it is shared, so the other copies never observe the change.
+	 *       Const access never copies, prefer it for read-only passes over a score that may be
+	 *       shared with a snapshot.
+	 * @warning References and iterators obtained through non-const access stay bound to the
+	 *          storage they were taken from. Writing through them after the wrapper was copied
+	 *          modifies the storage seen by the copy as well, so take snapshots before them
+	 */
+	template <typename Container>
+	class CopyOnWrite
+	{
+	  private:
+		std::shared_ptr<Container> data;
+
+		Container& mutate()
+		{
+			if (data.use_count() > 1)
+				data = std::make_shared<Container>(*data);
+
+			return *data;
+		}
+
+	  public:
+		using value_type = typename Container::value_type;
+		using size_type = typename Container::size_type;
+		using iterator = typename Container::iterator;
+		using const_iterator = typename Container::const_iterator;
+
+		CopyOnWrite() : data{ std::make_shared<Container>() } {}
+		CopyOnWrite(Container container)
+		    : data{ std::make_shared<Container>(std::move(container)) }
+		{
+		}
+
+		// Moves fall back to these, which are as cheap and keep the source usable
+		CopyOnWrite(const CopyOnWrite&) = default;
+		CopyOnWrite& operator=(const CopyOnWrite&) = default;
+
+		CopyOnWrite& operator=(Container container)
+		{
+			data = std::make_shared<Container>(std::move(container));
+			return *this;
+		}
+
+		inline const Container& get() const { return *data; }
+		inline operator const Container&() const { return *data; }
+		// Returns whether both wrappers currently refer to the same storage
+		inline bool sharesWith(const CopyOnWrite& other) const { return data == other.data; }
+
+		inline size_type size() const { return data->size(); }
+		inline bool empty() const { return data->empty(); }
+
+		inline const_iterator begin() const { return data->cbegin(); }
+		inline const_iterator end() const { return data->cend(); }
+		inline const_iterator cbegin() const { return data->cbegin(); }
+		inline const_iterator cend() const { return data->cend(); }
+		inline iterator begin() { return mutate().begin(); }
+		inline iterator end() { return mutate().end(); }
+
+		template <typename Key> inline size_type count(const Key& key) const
+		{
+			return data->count(key);
+		}
+
+		template <typename Key> inline const_iterator find(const Key& key) const
+		{
+			return data->find(key);
+		}
+
+		template <typename Key> inline iterator find(const Key& key) { return mutate().find(key); }
+
+		template <typename Key> inline decltype(auto) at(const Key& key) const
+		{
+			return std::as_const(*data).at(key);
+		}
+
+		template <typename Key> inline decltype(auto) at(const Key& key)
+		{
+			return mutate().at(key);
+		}
+
+		template <typename Key> inline decltype(auto) operator[](const Key& key) const
+		{
+			return std::as_const(*data)[key];
+		}
+
+		template <typename Key> inline decltype(auto) operator[](const Key& key)
+		{
+			return mutate()[key];
+		}
+
+		inline decltype(auto) front() const { return data->front(); }
+		inline decltype(auto) back() const { return data->back(); }
+		inline decltype(auto) front() { return mutate().front(); }
+		inline decltype(auto) back() { return mutate().back(); }
+
+		// Overloads taking the value type directly keep braced initializers working
+		inline decltype(auto) insert(const value_type& value) { return mutate().insert(value); }
+		inline decltype(auto) insert(value_type&& value) { return mutate().insert(std::move(value)); }
+
+		template <typename... Args> inline decltype(auto) insert(Args&&... args)
+		{
+			return mutate().insert(std::forward<Args>(args)...);
+		}
+
+		template <typename... Args> inline decltype(auto) emplace(Args&&... args)
+		{
+			return mutate().emplace(std::forward<Args>(args)...);
+		}
+
+		template <typename... Args> inline decltype(auto) emplace_back(Args&&... args)
+		{
+			return mutate().emplace_back(std::forward<Args>(args)...);
+		}
+
+		inline void push_back(const value_type& value) { mutate().push_back(value); }
+		inline void push_back(value_type&& value) { mutate().push_back(std::move(value)); }
+
+		inline void pop_back() { mutate().pop_back(); }
+
+		template <typename... Args> inline decltype(auto) erase(Args&&... args)
+		{
+			return mutate().erase(std::forward<Args>(args)...);
+		}
+
+		inline void reserve(size_type count) { mutate().reserve(count); }
+
+		// Drops the reference to the shared storage instead of copying it just to clear it
+		inline void clear()
+		{
+			if (data.use_count() > 1)
+				data = std::make_shared<Container>();
+			else
+				data->clear();
+		}
+	};
+}
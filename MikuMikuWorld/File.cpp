@@ -1,6 +1,5 @@
 #include "File.h"
 #include "IO.h"
-#include <Windows.h>
 #include <algorithm>
 #include <ctime>
 #include <stdio.h>
@@ -8,6 +7,12 @@
 #include <stdlib.h>
 #include <filesystem>
 #include <chrono>
+#include <cstring>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
 
 namespace IO
 {
@@ -32,7 +37,12 @@ namespace IO
 		if (stream)
 			close();
 
+#ifdef _WIN32
 		stream = _wfopen(filename.c_str(), mode);
+#else
+		std::wstring wMode(mode);
+		stream = fopen(wideStringToMb(filename).c_str(), wideStringToMb(wMode).c_str());
+#endif
 		if (!stream)
 			std::wcerr << L"Failed to open file: " << filename << std::endl;
 	}
@@ -44,6 +54,16 @@ namespace IO
 		open(wFileName, wMode.c_str());
 	}
 
+	FILE* File::openStream(const std::string& filename, const char* mode)
+	{
+#ifdef _WIN32
+		std::wstring wMode(mode, mode + strlen(mode));
+		return _wfopen(mbToWideStr(filename).c_str(), wMode.c_str());
+#else
+		return fopen(filename.c_str(), mode);
+#endif
+	}
+
 	void File::close()
 	{
 		if (stream)
@@ -62,7 +82,11 @@ namespace IO
 	std::chrono::time_point<std::chrono::system_clock> File::getLastWriteTime() const
 	{
 		struct stat fileStat;
+#ifdef _WIN32
 		fstat(_fileno(stream), &fileStat);
+#else
+		fstat(fileno(stream), &fileStat);
+#endif
 		auto time = fileStat.st_mtime;
 
 		return std::chrono::system_clock::from_time_t(time);
@@ -97,6 +121,12 @@ namespace IO
 				break;
 		}
 
+#ifndef _WIN32
+		// Match the line ending translation of text mode streams on Windows
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+#endif
+
 		return line;
 	}
 
@@ -189,8 +219,7 @@ namespace IO
 
 	bool File::exists(const std::string& path)
 	{
-		std::wstring wPath = mbToWideStr(path);
-		return std::filesystem::exists(wPath);
+		return std::filesystem::exists(std::filesystem::u8path(path));
 	}
 
 	bool File::exists(const std::wstring& path)
@@ -198,86 +227,25 @@ namespace IO
 		return std::filesystem::exists(path);
 	}
 
-	FileDialogResult FileDialog::showFileDialog(DialogType type, DialogSelectType selectType)
-	{
-		std::wstring wTitle = mbToWideStr(title);
-
-		OPENFILENAMEW ofn;
-		memset(&ofn, 0, sizeof(ofn));
-		ofn.lStructSize = sizeof(ofn);
-		ofn.hwndOwner = reinterpret_cast<HWND>(parentWindowHandle);
-		ofn.lpstrTitle = wTitle.c_str();
-		ofn.nFilterIndex = filterIndex + 1;
-		ofn.nFileOffset = 0;
-		ofn.nMaxFile = MAX_PATH;
-		ofn.Flags = OFN_LONGNAMES | OFN_EXPLORER | OFN_ENABLESIZING | OFN_OVERWRITEPROMPT |
-		            OFN_HIDEREADONLY | OFN_PATHMUSTEXIST;
-
-		std::wstring wDefaultExtension = mbToWideStr(defaultExtension);
-		ofn.lpstrDefExt = wDefaultExtension.c_str();
-
-		std::vector<std::wstring> ofnFilters;
-		ofnFilters.reserve(filters.size());
-
-		/*
-		    since '\0' terminates the string,
-		    we'll do a C# by using ' | ' then replacing it with '\0' when constructing the final
-		   wide string
-		*/
-		std::string filtersCombined;
-		for (const auto& filter : filters)
-		{
-			filtersCombined.append(filter.filterName)
-			    .append(" (")
-			    .append(filter.filterType)
-			    .append(")|")
-			    .append(filter.filterType)
-			    .append("|");
-		}
-
-		std::wstring wFiltersCombined = mbToWideStr(filtersCombined);
-		std::replace(wFiltersCombined.begin(), wFiltersCombined.end(), '|', '\0');
-		ofn.lpstrFilter = wFiltersCombined.c_str();
-
-		std::wstring wInputFilename = mbToWideStr(inputFilename);
-		wchar_t ofnFilename[1024]{ 0 };
-
-		// suppress return value not used warning
-#pragma warning(suppress : 6031)
-		lstrcpynW(ofnFilename, wInputFilename.c_str(), 1024);
-		ofn.lpstrFile = ofnFilename;
-
-		if (type == DialogType::Save)
-		{
-			if (GetSaveFileNameW(&ofn))
-			{
-				outputFilename = wideStringToMb(ofn.lpstrFile);
-			}
-			else
-			{
-				// user canceled
-				return FileDialogResult::Cancel;
-			}
-		}
-		else if (GetOpenFileNameW(&ofn))
-		{
-			outputFilename = wideStringToMb(ofn.lpstrFile);
-		}
-		else
-		{
-			return FileDialogResult::Cancel;
-		}
-
-		return outputFilename.empty() ? FileDialogResult::Cancel : FileDialogResult::OK;
-	}
-
-	FileDialogResult FileDialog::openFile()
+	bool File::replace(const std::string& source, const std::string& destination)
 	{
-		return showFileDialog(DialogType::Open, DialogSelectType::File);
+#ifdef _WIN32
+		std::wstring wSource = mbToWideStr(source);
+		std::wstring wDestination = mbToWideStr(destination);
+		return MoveFileExW(wSource.c_str(), wDestination.c_str(),
+		                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+		// rename replaces the destination atomically on POSIX systems
+		std::error_code error;
+		std::filesystem::rename(std::filesystem::u8path(source),
+		                        std::filesystem::u8path(destination), error);
+		return !error;
+#endif
 	}
 
-	FileDialogResult FileDialog::saveFile()
+	bool File::remove(const std::string& path)
 	{
-		return showFileDialog(DialogType::Save, DialogSelectType::File);
+		std::error_code error;
+		return std::filesystem::remove(std::filesystem::u8path(path), error);
 	}
 }
@@ -1,13 +1,11 @@
 #pragma once
 #include <chrono>
+#include <cstdio>
 #include <string>
 #include <vector>
 
 namespace IO
 {
-	constexpr const char* allFilesName{ "All Files" };
-	constexpr const char* allFilesFilter{ "*.*" };
-
 	class File
 	{
 	  private:
@@ -27,6 +25,11 @@ namespace IO
 		static std::string fixPath(const std::string& path);
 		static bool exists(const std::string& path);
 		static bool exists(const std::wstring& path);
+		// Moves `source` over `destination` in a single step, replacing it if it exists
+		static bool replace(const std::string& source, const std::string& destination);
+		static bool remove(const std::string& path);
+		// Opens a C stream for a UTF-8 path, the caller is responsible for closing it
+		static FILE* openStream(const std::string& filename, const char* mode);
 
 		void open(const std::wstring& filename, const wchar_t* mode);
 		void open(const std::string& filename, const char* mode);
@@ -43,47 +46,4 @@ namespace IO
 		void writeAllLines(const std::vector<std::string>& lines);
 		bool isEndofFile() const;
 	};
-
-	enum class FileDialogResult : uint8_t
-	{
-		Error,
-		Cancel,
-		OK
-	};
-
-	enum class DialogType : uint8_t
-	{
-		Open,
-		Save
-	};
-
-	enum class DialogSelectType : uint8_t
-	{
-		File,
-		Folder
-	};
-
-	struct FileDialogFilter
-	{
-		std::string filterName;
-		std::string filterType;
-	};
-
-	class FileDialog
-	{
-	  private:
-		FileDialogResult showFileDialog(DialogType type, DialogSelectType selectType);
-
-	  public:
-		std::string title;
-		std::vector<FileDialogFilter> filters;
-		std::string inputFilename;
-		std::string outputFilename;
-		std::string defaultExtension;
-		uint32_t filterIndex = 0;
-		void* parentWindowHandle = nullptr;
-
-		FileDialogResult openFile();
-		FileDialogResult saveFile();
-	};
 }
@@ -0,0 +1,90 @@
+#include "FileDialog.h"
+#include "IO.h"
+#include <Windows.h>
+#include <algorithm>
+
+namespace IO
+{
+	FileDialogResult FileDialog::showFileDialog(DialogType type, DialogSelectType selectType)
+	{
+		std::wstring wTitle = mbToWideStr(title);
+
+		OPENFILENAMEW ofn;
+		memset(&ofn, 0, sizeof(ofn));
+		ofn.lStructSize = sizeof(ofn);
+		ofn.hwndOwner = reinterpret_cast<HWND>(parentWindowHandle);
+		ofn.lpstrTitle = wTitle.c_str();
+		ofn.nFilterIndex = filterIndex + 1;
+		ofn.nFileOffset = 0;
+		ofn.nMaxFile = MAX_PATH;
+		ofn.Flags = OFN_LONGNAMES | OFN_EXPLORER | OFN_ENABLESIZING | OFN_OVERWRITEPROMPT |
+		            OFN_HIDEREADONLY | OFN_PATHMUSTEXIST;
+
+		std::wstring wDefaultExtension = mbToWideStr(defaultExtension);
+		ofn.lpstrDefExt = wDefaultExtension.c_str();
+
+		std::vector<std::wstring> ofnFilters;
+		ofnFilters.reserve(filters.size());
+
+		/*
+		    since '\0' terminates the string,
+		    we'll do a C# by using ' | ' then replacing it with '\0' when constructing the final
+		   wide string
+		*/
+		std::string filtersCombined;
+		for (const auto& filter : filters)
+		{
+			filtersCombined.append(filter.filterName)
+			    .append(" (")
+			    .append(filter.filterType)
+			    .append(")|")
+			    .append(filter.filterType)
+			    .append("|");
+		}
+
+		std::wstring wFiltersCombined = mbToWideStr(filtersCombined);
+		std::replace(wFiltersCombined.begin(), wFiltersCombined.end(), '|', '\0');
+		ofn.lpstrFilter = wFiltersCombined.c_str();
+
+		std::wstring wInputFilename = mbToWideStr(inputFilename);
+		wchar_t ofnFilename[1024]{ 0 };
+
+		// suppress return value not used warning
+#pragma warning(suppress : 6031)
+		lstrcpynW(ofnFilename, wInputFilename.c_str(), 1024);
+		ofn.lpstrFile = ofnFilename;
+
+		if (type == DialogType::Save)
+		{
+			if (GetSaveFileNameW(&ofn))
+			{
+				outputFilename = wideStringToMb(ofn.lpstrFile);
+			}
+			else
+			{
+				// user canceled
+				return FileDialogResult::Cancel;
+			}
+		}
+		else if (GetOpenFileNameW(&ofn))
+		{
+			outputFilename = wideStringToMb(ofn.lpstrFile);
+		}
+		else
+		{
+			return FileDialogResult::Cancel;
+		}
+
+		return outputFilename.empty() ? FileDialogResult::Cancel : FileDialogResult::OK;
+	}
+
+	FileDialogResult FileDialog::openFile()
+	{
+		return showFileDialog(DialogType::Open, DialogSelectType::File);
+	}
+
+	FileDialogResult FileDialog::saveFile()
+	{
+		return showFileDialog(DialogType::Save, DialogSelectType::File);
+	}
+}
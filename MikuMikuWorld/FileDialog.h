@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace IO
+{
+	constexpr const char* allFilesName{ "All Files" };
+	constexpr const char* allFilesFilter{ "*.*" };
+
+	enum class FileDialogResult : uint8_t
+	{
+		Error,
+		Cancel,
+		OK
+	};
+
+	enum class DialogType : uint8_t
+	{
+		Open,
+		Save
+	};
+
+	enum class DialogSelectType : uint8_t
+	{
+		File,
+		Folder
+	};
+
+	struct FileDialogFilter
+	{
+		std::string filterName;
+		std::string filterType;
+	};
+
+	class FileDialog
+	{
+	  private:
+		FileDialogResult showFileDialog(DialogType type, DialogSelectType selectType);
+
+	  public:
+		std::string title;
+		std::vector<FileDialogFilter> filters;
+		std::string inputFilename;
+		std::string outputFilename;
+		std::string defaultExtension;
+		uint32_t filterIndex = 0;
+		void* parentWindowHandle = nullptr;
+
+		FileDialogResult openFile();
+		FileDialogResult saveFile();
+	};
+}
@@ -2,46 +2,83 @@
 
 namespace MikuMikuWorld
 {
-	Score HistoryManager::undo()
+	const ScoreDelta& HistoryManager::undo(Score& score)
 	{
-		History history = undoHistory.top();
-		redoHistory.push(history);
-		undoHistory.pop();
-
-		return history.prev;
+		// Entries are moved between the stacks, the score is patched in place by the delta
+		undoHistory.back().delta.applyBackward(score);
+		redoHistory.push(std::move(undoHistory.back()));
+		undoHistory.pop_back();
+		return redoHistory.top().delta;
 	}
 
-	Score HistoryManager::redo()
+	const ScoreDelta& HistoryManager::redo(Score& score)
 	{
-		History history = redoHistory.top();
-		undoHistory.push(history);
+		redoHistory.top().delta.applyForward(score);
+		undoHistory.push_back(std::move(redoHistory.top()));
 		redoHistory.pop();
-
-		return history.curr;
+		return undoHistory.back().delta;
 	}
 
 	void HistoryManager::pushHistory(const std::string& description, const Score& prev,
 	                                 const Score& curr)
 	{
-		History history{ description, prev, curr };
-		pushHistory(history);
+		History history{ description, ScoreDelta::between(prev, curr) };
+		pushHistory(std::move(history));
 	}
 
-	void HistoryManager::pushHistory(const History& history)
+	void HistoryManager::pushHistory(History history)
 	{
-		undoHistory.push(history);
-
 		while (!redoHistory.empty())
+		{
+			memoryUsage -= redoHistory.top().byteSize;
 			redoHistory.pop();
+		}
+
+		if (mergeSameDescription && !undoHistory.empty() &&
+		    undoHistory.back().description == history.description)
+		{
+			History& latest = undoHistory.back();
+			memoryUsage -= latest.byteSize;
+			latest.delta.merge(history.delta);
+			latest.byteSize = latest.delta.getByteSize() + latest.description.capacity();
+			memoryUsage += latest.byteSize;
+		}
+		else
+		{
+			history.byteSize = history.delta.getByteSize() + history.description.capacity();
+			memoryUsage += history.byteSize;
+			undoHistory.push_back(std::move(history));
+		}
+
+		evictOldest();
+	}
+
+	void HistoryManager::evictOldest()
+	{
+		if (!memoryLimit)
+			return;
+
+		while (memoryUsage > memoryLimit && undoHistory.size() > 1)
+		{
+			memoryUsage -= undoHistory.front().byteSize;
+			undoHistory.pop_front();
+		}
+	}
+
+	void HistoryManager::setMemoryLimit(size_t bytes)
+	{
+		memoryLimit = bytes;
+		evictOldest();
 	}
 
 	void HistoryManager::clear()
 	{
-		while (!undoHistory.empty())
-			undoHistory.pop();
+		undoHistory.clear();
 
 		while (!redoHistory.empty())
 			redoHistory.pop();
+
+		memoryUsage = 0;
 	}
 
 	bool HistoryManager::hasUndo() const { return undoHistory.size(); }
@@ -54,7 +91,7 @@ namespace MikuMikuWorld
 
 	std::string HistoryManager::peekUndo() const
 	{
-		return undoHistory.size() ? undoHistory.top().description : "";
+		return undoHistory.size() ? undoHistory.back().description : "";
 	}
 
 	std::string HistoryManager::peekRedo() const
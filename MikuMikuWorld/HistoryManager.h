@@ -1,38 +1,62 @@
 #pragma once
+#include <deque>
 #include <stack>
 #include <map>
 #include <unordered_map>
 #include <string>
-#include "Score.h"
+#include "ScoreDelta.h"
 
 namespace MikuMikuWorld
 {
 	struct History
 	{
 		std::string description;
-		Score prev;
-		Score curr;
+		// Changes made by the edit, applied backward on undo and forward on redo
+		ScoreDelta delta;
+		// Approximate memory used by this entry, see `ScoreDelta::getByteSize`
+		size_t byteSize{};
 	};
 
 	class HistoryManager
 	{
 	  private:
-		std::stack<History> undoHistory;
+		// The back holds the latest edit while the front is evicted first
+		std::deque<History> undoHistory;
 		std::stack<History> redoHistory;
 
+		size_t memoryUsage{};
+		// 0 means unlimited
+		size_t memoryLimit{};
+		bool mergeSameDescription{ false };
+
+		void evictOldest();
+
 	  public:
-		Score undo();
-		Score redo();
+		// Reverts the latest edit on `score`, which must be the current version of the score.
+		// Returns the reverted changes, valid until the history is modified again
+		const ScoreDelta& undo(Score& score);
+		// Reapplies the latest undone edit on `score` and returns the reapplied changes
+		const ScoreDelta& redo(Score& score);
 
 		int undoCount() const;
 		int redoCount() const;
 		std::string peekUndo() const;
 		std::string peekRedo() const;
 
-		void pushHistory(const History& history);
+		void pushHistory(History history);
 		void pushHistory(const std::string& description, const Score& prev, const Score& curr);
 		void clear();
 		bool hasUndo() const;
 		bool hasRedo() const;
+
+		inline size_t getMemoryUsage() const { return memoryUsage; }
+		/**
+		 * @brief Set the memory budget of the history in bytes, 0 for unlimited
+		 * @note The oldest undo entries are evicted once the budget is exceeded, but the latest
+		 *       one is always kept
+		 */
+		void setMemoryLimit(size_t bytes);
+		// Whether an edit with the same description as the latest one is merged into it
+		inline void setMergeSameDescription(bool merge) { mergeSameDescription = merge; }
 	};
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "HoldCurveCache.h"
+#include "Score.h"
+
+namespace MikuMikuWorld
+{
+	bool HoldCurveKey::operator==(const HoldCurveKey& other) const
+	{
+		return startTick == other.startTick && endTick == other.endTick &&
+		       startLane == other.startLane && startWidth == other.startWidth &&
+		       endLane == other.endLane && endWidth == other.endWidth &&
+		       startLayer == other.startLayer && endLayer == other.endLayer &&
+		       ease == other.ease && steps == other.steps && tickHeight == other.tickHeight &&
+		       laneWidth == other.laneWidth && laneOffset == other.laneOffset &&
+		       texture == other.texture && sprite == other.sprite &&
+		       selectedLayer == other.selectedLayer && tint[0] == other.tint[0] &&
+		       tint[1] == other.tint[1] && tint[2] == other.tint[2] && tint[3] == other.tint[3] &&
+		       startAlpha == other.startAlpha && endAlpha == other.endAlpha;
+	}
+
+	void HoldCurveCache::prune(const Score& score)
+	{
+		for (auto it = holds.begin(); it != holds.end();)
+		{
+			if (score.holdNotes.find(it->first) == score.holdNotes.end())
+				it = holds.erase(it);
+			else
+				++it;
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "Note.h"
+#include "Rendering/Quad.h"
+#include <unordered_map>
+#include <vector>
+
+namespace MikuMikuWorld
+{
+	struct Score;
+
+	// Everything the geometry of a hold segment depends on besides the scroll position
+	struct HoldCurveKey
+	{
+		int startTick;
+		int endTick;
+		float startLane;
+		float startWidth;
+		float endLane;
+		float endWidth;
+		int startLayer;
+		int endLayer;
+		EaseType ease;
+		int steps;
+
+		// Timeline layout: pixels per tick, lane width and the x position of lane 0
+		float tickHeight;
+		float laneWidth;
+		float laneOffset;
+
+		// Appearance of the path
+		unsigned int texture;
+		int sprite;
+		int selectedLayer;
+		float tint[4];
+		float startAlpha;
+		float endAlpha;
+
+		bool operator==(const HoldCurveKey& other) const;
+		bool operator!=(const HoldCurveKey& other) const { return !(*this == other); }
+	};
+
+	/**
+	 * @brief Finished quads of a hold's path between two of its notes
+	 * @note The quads' y positions are measured from tick 0 so they stay valid while scrolling,
+	 *       the timeline adds the scroll position when drawing them. Any other change to the
+	 *       segment's key requires building the quads again
+	 */
+	struct HoldCurveSegment
+	{
+		// Quads drawn for each step of the path
+		static constexpr int quadsPerStep = 3;
+
+		HoldCurveKey key{};
+		bool valid{ false };
+		std::vector<Quad> quads;
+
+		// Whether the cached quads were built for `other`
+		inline bool matches(const HoldCurveKey& other) const { return valid && key == other; }
+	};
+
+	/**
+	 * @brief Per hold cache of `HoldCurveSegment`s keyed on the ID of the hold's start note
+	 * @note Segments validate themselves against their key, so edits to a hold's notes only
+	 *       rebuild the segments that changed. Holds removed from the score are dropped by `prune`
+	 */
+	class HoldCurveCache
+	{
+	  private:
+		std::unordered_map<int, std::vector<HoldCurveSegment>> holds;
+
+	  public:
+		inline void invalidate() { holds.clear(); }
+
+		// Drops the segments of holds that are no longer in the score
+		void prune(const Score& score);
+
+		std::vector<HoldCurveSegment>& getSegments(int holdID) { return holds[holdID]; }
+	};
+}
@@ -1,12 +1,28 @@
 #include "IO.h"
-#include <Windows.h>
 #include <algorithm>
+#include <cctype>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <codecvt>
+#include <cstdio>
+#include <locale>
+#endif
 
 namespace IO
 {
 	MessageBoxResult messageBox(std::string title, std::string message, MessageBoxButtons buttons,
 	                            MessageBoxIcon icon, void* parentWindow)
 	{
+#ifndef _WIN32
+		// There is no native message box elsewhere, report the message on the console instead
+		(void)buttons;
+		(void)icon;
+		(void)parentWindow;
+		fprintf(stderr, "%s: %s\n", title.c_str(), message.c_str());
+		return MessageBoxResult::None;
+#else
 		UINT flags = 0;
 		switch (icon)
 		{
@@ -64,6 +80,7 @@ namespace IO
 		default:
 			return MessageBoxResult::None;
 		}
+#endif
 	}
 
 	char* reverse(char* str)
@@ -131,7 +148,7 @@ namespace IO
 		if (str.empty())
 			return false;
 
-		return std::all_of(str.begin() + (str.at(0) == '-' ? 1 : 0), str.end(), std::isdigit);
+		return std::all_of(str.begin() + (str.at(0) == '-' ? 1 : 0), str.end(), ::isdigit);
 	}
 
 	std::string trim(const std::string& line)
@@ -162,6 +179,7 @@ namespace IO
 		return values;
 	}
 
+#ifdef _WIN32
 	std::string wideStringToMb(const std::wstring& str)
 	{
 		int size = WideCharToMultiByte(CP_UTF8, 0, &str[0], (int)str.size(), NULL, 0, NULL, NULL);
@@ -179,6 +197,17 @@ namespace IO
 
 		return wResult;
 	}
+#else
+	std::string wideStringToMb(const std::wstring& str)
+	{
+		return std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(str);
+	}
+
+	std::wstring mbToWideStr(const std::string& str)
+	{
+		return std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(str);
+	}
+#endif
 
 	std::string concat(const char* s1, const char* s2, const char* join)
 	{
@@ -5,9 +5,9 @@
 
 namespace MikuMikuWorld
 {
-	int nextID = 1;
-	int nextSkillID = 1;
-	int nextHiSpeedID = 1;
+	thread_local int nextID = 1;
+	thread_local int nextSkillID = 1;
+	thread_local int nextHiSpeedID = 1;
 
 	Note::Note(NoteType _type)
 	    : type{ _type }, parentID{ -1 }, tick{ 0 }, lane{ 0 }, width{ 3 }, critical{ false },
@@ -52,7 +52,8 @@ namespace MikuMikuWorld
 	};
 
 	extern NoteTextures noteTextures;
-	extern int nextID;
+	// ID counters are per thread so scores can be loaded and converted on several threads at once
+	extern thread_local int nextID;
 
 	class Note
 	{
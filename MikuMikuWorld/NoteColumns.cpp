@@ -0,0 +1,211 @@
+#include "NoteColumns.h"
+#include <stdexcept>
+
+namespace MikuMikuWorld
+{
+	int NoteView::getID() const { return columns->getIDs()[slot]; }
+
+	int NoteView::getParentID() const { return columns->getParentIDs()[slot]; }
+
+	int NoteView::getTick() const { return columns->getTicks()[slot]; }
+
+	float NoteView::getLane() const { return columns->getLanes()[slot]; }
+
+	float NoteView::getWidth() const { return columns->getWidths()[slot]; }
+
+	bool NoteView::isCritical() const
+	{
+		return columns->getFlags()[slot] & NoteColumns::FLAG_CRITICAL;
+	}
+
+	bool NoteView::isFriction() const
+	{
+		return columns->getFlags()[slot] & NoteColumns::FLAG_FRICTION;
+	}
+
+	FlickType NoteView::getFlick() const { return columns->getFlicks()[slot]; }
+
+	int NoteView::getLayer() const { return columns->getLayers()[slot]; }
+
+	NoteType NoteView::getType() const { return columns->getTypes()[slot]; }
+
+	bool NoteView::isHold() const
+	{
+		NoteType type = getType();
+		return type == NoteType::Hold || type == NoteType::HoldMid || type == NoteType::HoldEnd;
+	}
+
+	bool NoteView::isFlick() const
+	{
+		NoteType type = getType();
+		return getFlick() != FlickType::None && type != NoteType::Hold &&
+		       type != NoteType::HoldMid;
+	}
+
+	bool NoteView::hasEase() const
+	{
+		NoteType type = getType();
+		return type == NoteType::Hold || type == NoteType::HoldMid;
+	}
+
+	Note NoteView::toNote() const
+	{
+		return Note(getType(), getID(), getTick(), getLane(), getWidth(), getLayer(), isCritical(),
+		            isFriction(), getFlick(), getParentID());
+	}
+
+	void NoteColumns::writeSlot(int slot, const Note& note)
+	{
+		uint8_t noteFlags{};
+		if (note.critical)
+			noteFlags |= FLAG_CRITICAL;
+		if (note.friction)
+			noteFlags |= FLAG_FRICTION;
+
+		ids[slot] = note.ID;
+		parentIDs[slot] = note.parentID;
+		ticks[slot] = note.tick;
+		lanes[slot] = note.lane;
+		widths[slot] = note.width;
+		types[slot] = note.getType();
+		flags[slot] = noteFlags;
+		flicks[slot] = note.flick;
+		layers[slot] = note.layer;
+	}
+
+	void NoteColumns::update(const std::unordered_map<int, Note>& notes)
+	{
+		if (dirty)
+			assign(notes);
+	}
+
+	void NoteColumns::assign(const std::unordered_map<int, Note>& notes)
+	{
+		clear();
+
+		const size_t count = notes.size();
+		slots.reserve(count);
+		ids.resize(count);
+		parentIDs.resize(count);
+		ticks.resize(count);
+		lanes.resize(count);
+		widths.resize(count);
+		types.resize(count);
+		flags.resize(count);
+		flicks.resize(count);
+		layers.resize(count);
+
+		int slot = 0;
+		for (const auto& [id, note] : notes)
+		{
+			slots[id] = slot;
+			writeSlot(slot++, note);
+		}
+
+		dirty = false;
+	}
+
+	void NoteColumns::apply(const MapDelta<int, Note>& delta, bool forward)
+	{
+		// The next update rebuilds everything anyway
+		if (dirty)
+			return;
+
+		for (const auto& entry : delta.entries)
+		{
+			if (forward ? entry.existsAfter : entry.existedBefore)
+				set(forward ? entry.after : entry.before);
+			else
+				erase(entry.key);
+		}
+	}
+
+	void NoteColumns::set(const Note& note)
+	{
+		auto it = slots.find(note.ID);
+		if (it != slots.end())
+		{
+			writeSlot(it->second, note);
+			return;
+		}
+
+		const size_t count = size() + 1;
+		ids.resize(count);
+		parentIDs.resize(count);
+		ticks.resize(count);
+		lanes.resize(count);
+		widths.resize(count);
+		types.resize(count);
+		flags.resize(count);
+		flicks.resize(count);
+		layers.resize(count);
+
+		slots[note.ID] = count - 1;
+		writeSlot(count - 1, note);
+	}
+
+	bool NoteColumns::erase(int ID)
+	{
+		auto it = slots.find(ID);
+		if (it == slots.end())
+			return false;
+
+		// Move the last note into the freed slot to keep the columns packed
+		const int slot = it->second;
+		const int last = size() - 1;
+		slots.erase(it);
+		if (slot != last)
+		{
+			slots[ids[last]] = slot;
+			ids[slot] = ids[last];
+			parentIDs[slot] = parentIDs[last];
+			ticks[slot] = ticks[last];
+			lanes[slot] = lanes[last];
+			widths[slot] = widths[last];
+			types[slot] = types[last];
+			flags[slot] = flags[last];
+			flicks[slot] = flicks[last];
+			layers[slot] = layers[last];
+		}
+
+		ids.pop_back();
+		parentIDs.pop_back();
+		ticks.pop_back();
+		lanes.pop_back();
+		widths.pop_back();
+		types.pop_back();
+		flags.pop_back();
+		flicks.pop_back();
+		layers.pop_back();
+		return true;
+	}
+
+	void NoteColumns::clear()
+	{
+		slots.clear();
+		ids.clear();
+		parentIDs.clear();
+		ticks.clear();
+		lanes.clear();
+		widths.clear();
+		types.clear();
+		flags.clear();
+		flicks.clear();
+		layers.clear();
+	}
+
+	int NoteColumns::slotOf(int ID) const
+	{
+		auto it = slots.find(ID);
+		return it != slots.end() ? it->second : -1;
+	}
+
+	NoteView NoteColumns::at(int ID) const
+	{
+		int slot = slotOf(ID);
+		if (slot == -1)
+			throw std::out_of_range("Note ID not found in NoteColumns::at");
+
+		return NoteView(*this, slot);
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "Note.h"
+#include "ScoreDelta.h"
+#include <unordered_map>
+#include <vector>
+
+namespace MikuMikuWorld
+{
+	class NoteColumns;
+
+	/**
+	 * @brief Read-only proxy to one note stored in `NoteColumns`, mirroring the query API of `Note`
+	 * @warning Views are invalidated by any insertion or removal on the owning columns
+	 */
+	class NoteView
+	{
+	  private:
+		const NoteColumns* columns;
+		int slot;
+
+	  public:
+		NoteView(const NoteColumns& _columns, int _slot) : columns{ &_columns }, slot{ _slot } {}
+
+		int getSlot() const noexcept { return slot; }
+
+		int getID() const;
+		int getParentID() const;
+		int getTick() const;
+		float getLane() const;
+		float getWidth() const;
+		bool isCritical() const;
+		bool isFriction() const;
+		FlickType getFlick() const;
+		int getLayer() const;
+		NoteType getType() const;
+
+		bool isHold() const;
+		bool isFlick() const;
+		bool hasEase() const;
+
+		// Returns a copy of the note the view refers to
+		Note toNote() const;
+	};
+
+	/**
+	 * @brief Dense structure-of-arrays storage of notes with an ID to slot indirection
+	 * @note Slots are kept packed: removing a note moves the last note into its slot, so full passes
+	 *       over the score are linear scans over contiguous columns.
+	 *       When used as a mirror of `Score::notes` it is kept up to date by applying the note
+	 *       changes of every edit, and only rebuilt by `update()` after `invalidate()` is called
+	 *       because the score was replaced
+	 */
+	class NoteColumns
+	{
+	  public:
+		enum Flags : uint8_t
+		{
+			FLAG_CRITICAL = 1 << 0,
+			FLAG_FRICTION = 1 << 1
+		};
+
+	  private:
+		std::unordered_map<int, int> slots;
+		std::vector<int> ids;
+		std::vector<int> parentIDs;
+		std::vector<int> ticks;
+		std::vector<float> lanes;
+		std::vector<float> widths;
+		std::vector<NoteType> types;
+		std::vector<uint8_t> flags;
+		std::vector<FlickType> flicks;
+		std::vector<int> layers;
+		bool dirty{ true };
+
+		void writeSlot(int slot, const Note& note);
+
+	  public:
+		inline void invalidate() { dirty = true; }
+		// Rebuilds the columns from `notes` if they were invalidated
+		void update(const std::unordered_map<int, Note>& notes);
+
+		void assign(const std::unordered_map<int, Note>& notes);
+		// Applies the note changes of an edit, forward for the edit itself or redo and backward for undo
+		void apply(const MapDelta<int, Note>& delta, bool forward);
+		// Inserts the note or overwrites the stored note with the same ID
+		void set(const Note& note);
+		// Returns whether a note with the ID was found and removed
+		bool erase(int ID);
+		void clear();
+
+		inline size_t size() const { return ids.size(); }
+		inline bool contains(int ID) const { return slots.find(ID) != slots.end(); }
+		// Returns the slot of the note with the ID or -1 if there is none
+		int slotOf(int ID) const;
+
+		inline NoteView operator[](int slot) const { return NoteView(*this, slot); }
+		/**
+		 * @brief Retrieve a view of the note with the given ID
+		 * @throw `std::out_of_range` if there is no such note
+		 */
+		NoteView at(int ID) const;
+
+		inline const std::vector<int>& getIDs() const { return ids; }
+		inline const std::vector<int>& getParentIDs() const { return parentIDs; }
+		inline const std::vector<int>& getTicks() const { return ticks; }
+		inline const std::vector<float>& getLanes() const { return lanes; }
+		inline const std::vector<float>& getWidths() const { return widths; }
+		inline const std::vector<NoteType>& getTypes() const { return types; }
+		inline const std::vector<uint8_t>& getFlags() const { return flags; }
+		inline const std::vector<FlickType>& getFlicks() const { return flicks; }
+		inline const std::vector<int>& getLayers() const { return layers; }
+	};
+}
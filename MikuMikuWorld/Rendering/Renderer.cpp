@@ -2,14 +2,30 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <algorithm>
+#include <climits>
+#include <numeric>
 
 namespace MikuMikuWorld
 {
-	Renderer::Renderer() : vBuffer{ VertexBuffer(maxQuads) }
+	static uint32_t toRGBA8(const Color& color)
+	{
+		auto channel = [](float value)
+		{ return (uint32_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+
+		return channel(color.r) | channel(color.g) << 8 | channel(color.b) << 16 |
+		       channel(color.a) << 24;
+	}
+
+	Renderer::Renderer()
+	    : numVertices{ 0 }, numBatchVertices{ 0 }, numIndices{ 0 }, numQuads{ 0 },
+	      numBatchQuads{ 0 }, numDrawCalls{ 0 }, numBatchDrawCalls{ 0 },
+	      vBuffer{ VertexBuffer(maxQuads * 4) }, minZIndex{ INT_MAX }, maxZIndex{ INT_MIN },
+	      batchTextureCount{ 0 }, batchStarted{ false }
 	{
 		vBuffer.setup();
 		vBuffer.bind();
 		quads.reserve(maxQuads);
+		quadOrder.reserve(maxQuads);
 		init();
 	}
 
@@ -104,11 +120,12 @@ namespace MikuMikuWorld
 	                          const Color& tint, int z)
 	{
 		DirectX::XMMATRIX model = getModelMatrix(pos, rot, sz);
-		DirectX::XMVECTOR color{ tint.r, tint.g, tint.b, tint.a };
 		setUVCoords(tex, x1, x2, y1, y2);
 		setAnchor(anchor);
+		for (auto& position : vPos)
+			position = DirectX::XMVector2Transform(position, model);
 
-		pushQuad(vPos, uvCoords, model, color, tex.getID(), z);
+		pushQuad(vPos, uvCoords, tint, tex.getID(), z);
 	}
 
 	void Renderer::drawQuad(const Vector2& p1, const Vector2& p2, const Vector2& p3,
@@ -120,9 +137,44 @@ namespace MikuMikuWorld
 		vPos[1] = DirectX::XMVECTOR{ p2.x, p2.y, 0.0f, 1.0f };
 		vPos[2] = DirectX::XMVECTOR{ p1.x, p1.y, 0.0f, 1.0f };
 		vPos[3] = DirectX::XMVECTOR{ p3.x, p3.y, 0.0f, 1.0f };
-		DirectX::XMVECTOR color{ tint.r, tint.g, tint.b, tint.a };
 
-		pushQuad(vPos, uvCoords, DirectX::XMMatrixIdentity(), color, tex.getID(), z);
+		pushQuad(vPos, uvCoords, tint, tex.getID(), z);
+	}
+
+	Quad Renderer::createQuad(const Vector2& p1, const Vector2& p2, const Vector2& p3,
+	                          const Vector2& p4, const Texture& tex, float x1, float x2, float y1,
+	                          float y2, const Color& tint, int z) const
+	{
+		const float left = x1 / tex.getWidth();
+		const float right = x2 / tex.getWidth();
+		const float top = y1 / tex.getHeight();
+		const float bottom = y2 / tex.getHeight();
+		const uint32_t color = toRGBA8(tint);
+
+		// Same corners and UVs as drawQuad
+		return Quad{ z,
+			         (int)tex.getID(),
+			         { { p4.x, p4.y, right, top, color },
+			           { p2.x, p2.y, right, bottom, color },
+			           { p1.x, p1.y, left, bottom, color },
+			           { p3.x, p3.y, left, top, color } } };
+	}
+
+	void Renderer::drawQuads(const Quad* source, size_t count, float offsetY)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			Quad& q = quads.emplace_back(source[i]);
+			for (Vertex& vertex : q.vertices)
+				vertex.y += offsetY;
+
+			minZIndex = std::min(minZIndex, q.zIndex);
+			maxZIndex = std::max(maxZIndex, q.zIndex);
+		}
+
+		numQuads += count;
+		numVertices += count * 4;
+		numIndices += count * 6;
 	}
 
 	void Renderer::drawRectangle(Vector2 position, Vector2 size, const Texture& tex, float x1,
@@ -137,21 +189,22 @@ namespace MikuMikuWorld
 	}
 
 	void Renderer::pushQuad(const std::array<DirectX::XMVECTOR, 4>& pos,
-	                        const std::array<DirectX::XMVECTOR, 4>& uv, const DirectX::XMMATRIX& m,
-	                        const DirectX::XMVECTOR& col, int tex, int z)
+	                        const std::array<DirectX::XMVECTOR, 4>& uv, const Color& col, int tex,
+	                        int z)
 	{
-		Quad q;
-		q.matrix = m;
+		const uint32_t color = toRGBA8(col);
+		Quad& q = quads.emplace_back();
 		q.texture = tex;
 		q.zIndex = z;
 		for (int i = 0; i < 4; ++i)
 		{
-			q.vertices[i].position = pos[i];
-			q.vertices[i].color = col;
-			q.vertices[i].uv = uvCoords[i];
+			q.vertices[i] = Vertex{ DirectX::XMVectorGetX(pos[i]), DirectX::XMVectorGetY(pos[i]),
+			                        DirectX::XMVectorGetX(uv[i]), DirectX::XMVectorGetY(uv[i]),
+			                        color };
 		}
 
-		quads.push_back(q);
+		minZIndex = std::min(minZIndex, z);
+		maxZIndex = std::max(maxZIndex, z);
 
 		++numQuads;
 		numVertices += 4;
@@ -163,12 +216,30 @@ namespace MikuMikuWorld
 		numIndices = 0;
 		numVertices = 0;
 		numQuads = 0;
+		numDrawCalls = 0;
+	}
+
+	void Renderer::bindTexture(int tex, int slot)
+	{
+		glActiveTexture(GL_TEXTURE0 + slot);
+		glBindTexture(GL_TEXTURE_2D, tex);
+	}
+
+	int Renderer::getTextureSlot(int tex) const
+	{
+		for (int slot = 0; slot < batchTextureCount; ++slot)
+			if (batchTextures[slot] == tex)
+				return slot;
+
+		return -1;
 	}
 
-	void Renderer::bindTexture(int tex)
+	void Renderer::flushBatch()
 	{
-		texID = tex;
-		glBindTexture(GL_TEXTURE_2D, texID);
+		vBuffer.uploadBuffer();
+		vBuffer.flushBuffer();
+		vBuffer.resetBufferPos();
+		++numDrawCalls;
 	}
 
 	void Renderer::beginBatch()
@@ -176,43 +247,86 @@ namespace MikuMikuWorld
 		batchStarted = true;
 		vBuffer.resetBufferPos();
 		quads.clear();
+		minZIndex = INT_MAX;
+		maxZIndex = INT_MIN;
 		resetRenderStats();
 	}
 
+	void Renderer::sortQuads()
+	{
+		quadOrder.resize(quads.size());
+
+		// There are only a few z indices in a frame, so count the quads of each instead of
+		// comparing them. Quads on the same z index keep their submission order either way
+		const int64_t zRange = (int64_t)maxZIndex - minZIndex + 1;
+		if (zRange > (int64_t)quads.size())
+		{
+			std::iota(quadOrder.begin(), quadOrder.end(), 0);
+			std::stable_sort(quadOrder.begin(), quadOrder.end(), [this](uint32_t a, uint32_t b)
+			                 { return quads[a].zIndex < quads[b].zIndex; });
+			return;
+		}
+
+		zOffsets.assign(zRange + 1, 0);
+		for (const Quad& q : quads)
+			++zOffsets[q.zIndex - minZIndex + 1];
+
+		for (size_t z = 1; z < zOffsets.size(); ++z)
+			zOffsets[z] += zOffsets[z - 1];
+
+		for (uint32_t i = 0; i < quads.size(); ++i)
+			quadOrder[zOffsets[quads[i].zIndex - minZIndex]++] = i;
+	}
+
 	void Renderer::endBatch()
 	{
 		numBatchVertices = numVertices;
 		numBatchQuads = numQuads;
+		numBatchDrawCalls = 0;
 
 		batchStarted = false;
 		if (!quads.size())
 			return;
 
-		std::stable_sort(quads.begin(), quads.end(),
-		                 [](const Quad& q1, const Quad& q2) { return q1.zIndex < q2.zIndex; });
+		sortQuads();
 
-		bindTexture(quads[0].texture);
+		// Quads of different textures share a draw call until the texture units run out
+		batchTextureCount = 0;
 		int vertexCount = 0;
-
-		for (const auto& q : quads)
+		for (uint32_t index : quadOrder)
 		{
-			if (texID != q.texture || vertexCount + 4 >= vBuffer.getCapacity())
+			const Quad& q = quads[index];
+			if (vertexCount + 4 > vBuffer.getCapacity())
 			{
-				vBuffer.uploadBuffer();
-				vBuffer.flushBuffer();
-				vBuffer.resetBufferPos();
+				flushBatch();
 				vertexCount = 0;
+			}
 
-				bindTexture(q.texture);
+			int slot = getTextureSlot(q.texture);
+			if (slot == -1)
+			{
+				if (batchTextureCount == maxBatchTextures)
+				{
+					if (vertexCount)
+						flushBatch();
+
+					vertexCount = 0;
+					batchTextureCount = 0;
+				}
+
+				slot = batchTextureCount++;
+				batchTextures[slot] = q.texture;
+				bindTexture(q.texture, slot);
 			}
 
-			vBuffer.pushBuffer(q);
+			vBuffer.pushBuffer(q, slot);
 			vertexCount += 4;
 		}
 
-		vBuffer.uploadBuffer();
-		vBuffer.flushBuffer();
-
-		batchStarted = false;
+		flushBatch();
+		glActiveTexture(GL_TEXTURE0);
+		numBatchDrawCalls = numDrawCalls;
 	}
+
+	void Renderer::endFrame() { vBuffer.endFrame(); }
 }
\ No newline at end of file
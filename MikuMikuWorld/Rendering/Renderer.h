@@ -4,12 +4,16 @@
 #include "Texture.h"
 #include "AnchorType.h"
 #include "VertexBuffer.h"
-#include <vector>
+#include <DirectXMath.h>
 #include <array>
+#include <cstdint>
+#include <vector>
 
 namespace MikuMikuWorld
 {
 	constexpr size_t maxQuads = 1500;
+	// Textures sampled by a single draw call, basic2d.frag declares the same number of samplers
+	constexpr int maxBatchTextures = 8;
 
 	class Renderer
 	{
@@ -19,18 +23,31 @@ namespace MikuMikuWorld
 		size_t numIndices;
 		size_t numQuads;
 		size_t numBatchQuads;
+		size_t numDrawCalls;
+		size_t numBatchDrawCalls;
 
 		VertexBuffer vBuffer;
 		std::vector<Quad> quads;
+		// Indices of `quads` in drawing order, filled when the batch ends
+		std::vector<uint32_t> quadOrder;
+		std::vector<uint32_t> zOffsets;
+		int minZIndex;
+		int maxZIndex;
 		std::array<DirectX::XMVECTOR, 4> vPos;
 		std::array<DirectX::XMVECTOR, 4> uvCoords;
 
+		// Textures bound to each texture unit for the current draw call
+		std::array<int, maxBatchTextures> batchTextures;
+		int batchTextureCount;
+
 		unsigned int vao, vbo, ebo;
-		int texID;
 		bool batchStarted;
 
 		void init();
 		void resetRenderStats();
+		void sortQuads();
+		int getTextureSlot(int tex) const;
+		void flushBatch();
 
 	  public:
 		Renderer();
@@ -45,6 +62,14 @@ namespace MikuMikuWorld
 		              const Texture& tex, float x1, float x2, float y1, float y2,
 		              const Color& tint = { 1.0f, 1.0f, 1.0f, 1.0f }, int z = 0);
 
+		// The quad drawQuad would add, for callers that keep it around to draw it again later
+		Quad createQuad(const Vector2& p1, const Vector2& p2, const Vector2& p3, const Vector2& p4,
+		                const Texture& tex, float x1, float x2, float y1, float y2,
+		                const Color& tint = { 1.0f, 1.0f, 1.0f, 1.0f }, int z = 0) const;
+
+		// Adds finished quads, moved down by `offsetY`
+		void drawQuads(const Quad* source, size_t count, float offsetY = 0.0f);
+
 		void drawRectangle(Vector2 position, Vector2 size, const Texture& tex, float x1, float x2,
 		                   float y1, float y2, Color tint, int z);
 
@@ -52,15 +77,21 @@ namespace MikuMikuWorld
 		void setAnchor(AnchorType type);
 		DirectX::XMMATRIX getModelMatrix(const Vector2& pos, const float rot, const Vector2& sz);
 
+		// Positions must already be transformed, the vertices are stored ready for upload
 		void pushQuad(const std::array<DirectX::XMVECTOR, 4>& pos,
-		              const std::array<DirectX::XMVECTOR, 4>& uv, const DirectX::XMMATRIX& m,
-		              const DirectX::XMVECTOR& col, int tex, int z);
+		              const std::array<DirectX::XMVECTOR, 4>& uv, const Color& col, int tex, int z);
 
-		void bindTexture(int tex);
+		void bindTexture(int tex, int slot);
 		void beginBatch();
 		void endBatch();
+		// Called once all batches of a frame have been drawn
+		void endFrame();
 
 		inline int getNumVertices() const { return numBatchVertices; }
 		inline int getNumQuads() const { return numBatchQuads; }
+		inline int getNumDrawCalls() const { return numBatchDrawCalls; }
+
+		inline void setStreamMode(VertexStreamMode mode) { vBuffer.setMode(mode); }
+		inline VertexStreamMode getStreamMode() const { return vBuffer.getMode(); }
 	};
 }
@@ -1,38 +1,21 @@
 #include "VertexBuffer.h"
 #include "glad/glad.h"
 #include <cstddef>
+#include <cstring>
 
 namespace MikuMikuWorld
 {
 	VertexBuffer::VertexBuffer(int _capacity)
-	    : vertexCapcity{ _capacity }, bufferPos{ 0 }, vao{ 0 }, vbo{ 0 }, ebo{ 0 }
+	    : batch(_capacity), ring(_capacity * ringRegionBatches, ringRegionCount),
+	      mode{ VertexStreamMode::SubData }, baseVertex{ 0 }, ringFences{}, vao{ 0 }, vbo{ 0 },
+	      ebo{ 0 }
 	{
-		buffer = nullptr;
-		indices = nullptr;
-		indexCapacity = (vertexCapcity * 6) / 4;
 	}
 
 	VertexBuffer::~VertexBuffer() { dispose(); }
 
 	void VertexBuffer::setup()
 	{
-		buffer = new Vertex[vertexCapcity];
-		indices = new int[indexCapacity];
-
-		size_t offset = 0;
-		for (size_t index = 0; index < indexCapacity; index += 6)
-		{
-			indices[index + 0] = offset + 0;
-			indices[index + 1] = offset + 1;
-			indices[index + 2] = offset + 2;
-
-			indices[index + 3] = offset + 2;
-			indices[index + 4] = offset + 3;
-			indices[index + 5] = offset + 0;
-
-			offset += 4;
-		}
-
 		glGenVertexArrays(1, &vao);
 		glBindVertexArray(vao);
 
@@ -40,23 +23,26 @@ namespace MikuMikuWorld
 		glGenBuffers(1, &ebo);
 
 		glBindBuffer(GL_ARRAY_BUFFER, vbo);
-		glBufferData(GL_ARRAY_BUFFER, vertexCapcity * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
+		allocateStorage();
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCapacity * sizeof(unsigned int), indices,
+		const std::vector<uint32_t>& indices = batch.getIndices();
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(),
 		             GL_STATIC_DRAW);
 
 		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		                      (void*)offsetof(Vertex, position));
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
 
 		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex),
 		                      (void*)offsetof(Vertex, color));
 
 		glEnableVertexAttribArray(2);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-		                      (void*)offsetof(Vertex, uv));
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, u));
+
+		glEnableVertexAttribArray(3);
+		glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(Vertex),
+		                       (void*)offsetof(Vertex, textureSlot));
 
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindVertexArray(0);
@@ -64,12 +50,15 @@ namespace MikuMikuWorld
 
 	void VertexBuffer::dispose()
 	{
-		delete[] buffer;
-		delete[] indices;
+		// A buffer that was never set up has no GL objects to delete
+		if (!vao)
+			return;
 
+		deleteFences();
 		glDeleteVertexArrays(1, &vao);
 		glDeleteBuffers(1, &vbo);
 		glDeleteBuffers(1, &ebo);
+		vao = vbo = ebo = 0;
 	}
 
 	void VertexBuffer::bind() const
@@ -78,34 +67,134 @@ namespace MikuMikuWorld
 		glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	}
 
-	int VertexBuffer::getSize() const { return bufferPos * sizeof(Vertex); }
+	void VertexBuffer::allocateStorage()
+	{
+		const int vertices =
+		    mode == VertexStreamMode::Ring ? ring.getCapacity() : batch.getCapacity();
+		glBufferData(GL_ARRAY_BUFFER, vertices * sizeof(Vertex), NULL,
+		             mode == VertexStreamMode::SubData ? GL_DYNAMIC_DRAW : GL_STREAM_DRAW);
+	}
 
-	int VertexBuffer::getCapacity() const { return vertexCapcity; }
+	void VertexBuffer::fenceRegion()
+	{
+		ringFences[ring.getRegion()] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void VertexBuffer::waitForRegion(int region)
+	{
+		GLsync fence = static_cast<GLsync>(ringFences[region]);
+		if (!fence)
+			return;
+
+		// The region was fenced at the end of the frame drawn ringRegionCount frames ago, this
+		// only waits if the GPU is that far behind or a frame overflowed into the next region
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(fence, 0, 1000000);
+
+		glDeleteSync(fence);
+		ringFences[region] = nullptr;
+	}
 
-	void VertexBuffer::pushBuffer(const Quad& q)
+	void VertexBuffer::deleteFences()
 	{
-		for (int offset = 0; offset < 4; ++offset)
+		for (void*& fence : ringFences)
 		{
-			buffer[bufferPos + offset].position =
-			    DirectX::XMVector2Transform(q.vertices[offset].position, q.matrix);
-			buffer[bufferPos + offset].color = q.vertices[offset].color;
-			buffer[bufferPos + offset].uv = q.vertices[offset].uv;
+			if (fence)
+				glDeleteSync(static_cast<GLsync>(fence));
+
+			fence = nullptr;
 		}
+	}
 
-		bufferPos += 4;
+	void VertexBuffer::setMode(VertexStreamMode streamMode)
+	{
+		if (streamMode == mode || streamMode >= VertexStreamMode::VertexStreamModeCount)
+			return;
+
+		mode = streamMode;
+		ring.reset();
+		baseVertex = 0;
+		if (!vao)
+			return;
+
+		deleteFences();
+		bind();
+		allocateStorage();
 	}
 
-	void VertexBuffer::resetBufferPos() { bufferPos = 0; }
+	VertexStreamMode VertexBuffer::getMode() const { return mode; }
+
+	int VertexBuffer::getSize() const { return batch.getByteSize(); }
+
+	int VertexBuffer::getCapacity() const { return batch.getCapacity(); }
+
+	const VertexBatch& VertexBuffer::getBatch() const { return batch; }
+
+	void VertexBuffer::pushBuffer(const Quad& q, int textureSlot) { batch.push(q, textureSlot); }
+
+	void VertexBuffer::resetBufferPos() { batch.clear(); }
 
 	void VertexBuffer::uploadBuffer()
 	{
 		size_t size = getSize();
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, buffer);
+		if (!size)
+			return;
+
+		switch (mode)
+		{
+		case VertexStreamMode::Orphan:
+			allocateStorage();
+			glBufferSubData(GL_ARRAY_BUFFER, 0, size, batch.getVertices());
+			break;
+
+		case VertexStreamMode::Ring:
+		{
+			baseVertex = ring.allocate(batch.getCount());
+			if (baseVertex == -1)
+			{
+				// The frame drew more than a region holds, continue in the next one
+				fenceRegion();
+				ring.advance();
+				baseVertex = ring.allocate(batch.getCount());
+			}
+
+			waitForRegion(ring.getRegion());
+			void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, baseVertex * sizeof(Vertex), size,
+			                                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+			                                    GL_MAP_UNSYNCHRONIZED_BIT);
+			if (mapped)
+			{
+				memcpy(mapped, batch.getVertices(), size);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+			}
+			break;
+		}
+
+		default:
+			glBufferSubData(GL_ARRAY_BUFFER, 0, size, batch.getVertices());
+			break;
+		}
 	}
 
 	void VertexBuffer::flushBuffer()
 	{
-		size_t numIndices = (bufferPos / 4) * 6;
-		glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0);
+		const int numIndices = batch.getIndexCount();
+		if (!numIndices)
+			return;
+
+		if (mode == VertexStreamMode::Ring)
+			glDrawElementsBaseVertex(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0, baseVertex);
+		else
+			glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0);
+	}
+
+	void VertexBuffer::endFrame()
+	{
+		if (mode != VertexStreamMode::Ring || !vao || !ring.isRegionUsed())
+			return;
+
+		fenceRegion();
+		ring.advance();
 	}
-}
\ No newline at end of file
+}
@@ -1,33 +1,50 @@
 #pragma once
-#include "Quad.h"
+#include "VertexStream.h"
+#include <array>
 
 namespace MikuMikuWorld
 {
 	class VertexBuffer
 	{
 	  private:
-		Vertex* buffer;
-		int* indices;
-		int indexCapacity;
-		int vertexCapcity;
-		int bufferPos;
+		static constexpr int ringRegionCount = 3;
+		// Full draw calls each ring region holds, a frame of the timeline takes far fewer
+		static constexpr int ringRegionBatches = 16;
+
+		VertexBatch batch;
+		StreamRing ring;
+		VertexStreamMode mode;
+		int baseVertex;
+		// GLsync handles of the frames that last drew from each ring region
+		std::array<void*, ringRegionCount> ringFences;
 
 		unsigned int vao;
 		unsigned int vbo;
 		unsigned int ebo;
 
+		void allocateStorage();
+		void fenceRegion();
+		void waitForRegion(int region);
+		void deleteFences();
+
 	  public:
+		// Only allocates the CPU side buffers, setup creates the GL objects
 		VertexBuffer(int _capacity);
 		~VertexBuffer();
 
 		void setup();
 		void dispose();
 		void bind() const;
-		void pushBuffer(const Quad& q);
+		void setMode(VertexStreamMode streamMode);
+		VertexStreamMode getMode() const;
+		void pushBuffer(const Quad& q, int textureSlot);
 		void resetBufferPos();
 		void uploadBuffer();
 		void flushBuffer();
+		// Fences the ring region written this frame, the next frame starts in the next region
+		void endFrame();
 		int getCapacity() const;
 		int getSize() const;
+		const VertexBatch& getBatch() const;
 	};
-}
\ No newline at end of file
+}
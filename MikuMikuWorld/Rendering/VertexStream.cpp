@@ -0,0 +1,88 @@
+#include "VertexStream.h"
+
+namespace MikuMikuWorld
+{
+	VertexBatch::VertexBatch(int capacity)
+	    : vertices(capacity), indices{ generateQuadIndices(capacity / 4) }, count{ 0 }
+	{
+	}
+
+	std::vector<uint32_t> VertexBatch::generateQuadIndices(int quadCount)
+	{
+		std::vector<uint32_t> quadIndices;
+		quadIndices.reserve(quadCount * 6);
+		for (uint32_t offset = 0; offset < (uint32_t)quadCount * 4; offset += 4)
+		{
+			quadIndices.push_back(offset + 0);
+			quadIndices.push_back(offset + 1);
+			quadIndices.push_back(offset + 2);
+
+			quadIndices.push_back(offset + 2);
+			quadIndices.push_back(offset + 3);
+			quadIndices.push_back(offset + 0);
+		}
+
+		return quadIndices;
+	}
+
+	void VertexBatch::push(const Quad& q, int textureSlot)
+	{
+		for (int offset = 0; offset < 4; ++offset)
+		{
+			vertices[count + offset] = q.vertices[offset];
+			vertices[count + offset].textureSlot = textureSlot;
+		}
+
+		count += 4;
+	}
+
+	void VertexBatch::clear() { count = 0; }
+
+	int VertexBatch::getCapacity() const { return vertices.size(); }
+
+	int VertexBatch::getCount() const { return count; }
+
+	int VertexBatch::getIndexCount() const { return (count / 4) * 6; }
+
+	size_t VertexBatch::getByteSize() const { return count * sizeof(Vertex); }
+
+	const Vertex* VertexBatch::getVertices() const { return vertices.data(); }
+
+	const std::vector<uint32_t>& VertexBatch::getIndices() const { return indices; }
+
+	StreamRing::StreamRing(int _regionCapacity, int _regionCount)
+	    : regionCapacity{ _regionCapacity }, regionCount{ _regionCount }, region{ 0 }, offset{ 0 }
+	{
+	}
+
+	int StreamRing::allocate(int vertexCount)
+	{
+		if (offset + vertexCount > regionCapacity)
+			return -1;
+
+		const int first = region * regionCapacity + offset;
+		offset += vertexCount;
+		return first;
+	}
+
+	int StreamRing::advance()
+	{
+		region = (region + 1) % regionCount;
+		offset = 0;
+		return region;
+	}
+
+	void StreamRing::reset()
+	{
+		region = 0;
+		offset = 0;
+	}
+
+	int StreamRing::getRegion() const { return region; }
+
+	int StreamRing::getRegionCapacity() const { return regionCapacity; }
+
+	int StreamRing::getCapacity() const { return regionCapacity * regionCount; }
+
+	bool StreamRing::isRegionUsed() const { return offset > 0; }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Quad.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MikuMikuWorld
+{
+	// How vertices reach the GPU buffer for each draw call
+	enum class VertexStreamMode : uint8_t
+	{
+		// Overwrite the start of a single buffer
+		SubData,
+		// Replace the buffer's storage before every upload so the driver never waits on it
+		Orphan,
+		// Append to the current frame's region of a larger buffer without synchronization, a
+		// region is fenced at the end of its frame and only written again once the GPU is done
+		Ring,
+		VertexStreamModeCount
+	};
+
+	constexpr const char* vertexStreamModes[] = { "Sub Data", "Orphan", "Ring" };
+
+	/**
+	 * @brief CPU side of a vertex buffer, holds the vertices of a draw call until they are uploaded
+	 * @note Does not depend on OpenGL so the generated vertex and index data can be checked
+	 *       without a GPU
+	 */
+	class VertexBatch
+	{
+	  private:
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		int count;
+
+	  public:
+		VertexBatch(int capacity);
+
+		// Two triangles for every four vertices: top-right, bottom-right, bottom-left, top-left
+		static std::vector<uint32_t> generateQuadIndices(int quadCount);
+
+		// The quad's vertices with their texture slot set, the caller checks the capacity
+		void push(const Quad& q, int textureSlot);
+		void clear();
+
+		int getCapacity() const;
+		int getCount() const;
+		int getIndexCount() const;
+		size_t getByteSize() const;
+		const Vertex* getVertices() const;
+		const std::vector<uint32_t>& getIndices() const;
+	};
+
+	/**
+	 * @brief Sub-allocates the draw calls of a frame from consecutive vertices of a ring buffer
+	 * @note The ring is split into one region per frame in flight. A frame that draws more than
+	 *       a region holds moves on to the next region early
+	 */
+	class StreamRing
+	{
+	  private:
+		int regionCapacity;
+		int regionCount;
+		int region;
+		int offset;
+
+	  public:
+		StreamRing(int _regionCapacity, int _regionCount);
+
+		/**
+		 * @brief Reserves vertices in the current region
+		 * @return The first reserved vertex, or -1 if the region has no room left for them
+		 */
+		int allocate(int vertexCount);
+
+		/**
+		 * @brief Moves to the start of the next region
+		 * @return The new region, the GPU must be done reading it before it is written
+		 */
+		int advance();
+		void reset();
+
+		int getRegion() const;
+		int getRegionCapacity() const;
+		int getCapacity() const;
+		// Whether the current region has been written since the ring last moved to it
+		bool isRegionUsed() const;
+	};
+}
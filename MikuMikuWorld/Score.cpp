@@ -4,6 +4,8 @@
 #include "Constants.h"
 #include "File.h"
 #include "IO.h"
+#include <algorithm>
+#include <cmath>
 #include <unordered_set>
 
 using namespace IO;
@@ -23,6 +25,22 @@ namespace MikuMikuWorld
 		HOLD_GUIDE = 1 << 2
 	};
 
+	// Packed per-note byte of the compact note encoding, the flick type is stored in the top bits
+	enum CompactNoteFlags
+	{
+		COMPACT_NOTE_CRITICAL = 1 << 0,
+		COMPACT_NOTE_FRICTION = 1 << 1,
+		COMPACT_NOTE_RAW_LANE = 1 << 2,
+		COMPACT_NOTE_RAW_WIDTH = 1 << 3,
+		COMPACT_NOTE_LAYER = 1 << 4,
+		COMPACT_NOTE_FLICK_SHIFT = 5
+	};
+
+	// Cyanvas version from which the note sections use the compact encoding
+	constexpr int COMPACT_CYANVAS_VERSION = 7;
+	// Lanes and widths are stored as varints in quarter lanes when that is lossless
+	constexpr float COMPACT_LANE_STEPS = 4.0f;
+
 	Score::Score()
 	{
 		metadata.title = "";
@@ -87,6 +105,112 @@ namespace MikuMikuWorld
 		writer->writeInt32(flags);
 	}
 
+	static bool toLaneSteps(float value, int32_t& steps)
+	{
+		float scaled = value * COMPACT_LANE_STEPS;
+		if (!std::isfinite(scaled) || std::abs(scaled) > (1 << 24))
+			return false;
+
+		steps = static_cast<int32_t>(std::lround(scaled));
+		return steps / COMPACT_LANE_STEPS == value;
+	}
+
+	// Ticks are stored relative to `previousTick`, which is updated to the tick of the note
+	Note readCompactNote(NoteType type, BinaryReader* reader, int& previousTick)
+	{
+		Note note(type);
+
+		uint8_t flags = reader->readUInt8();
+		note.tick = previousTick + reader->readVarInt32();
+		previousTick = note.tick;
+
+		note.lane = flags & COMPACT_NOTE_RAW_LANE ? reader->readSingle()
+		                                          : reader->readVarInt32() / COMPACT_LANE_STEPS;
+		note.width = flags & COMPACT_NOTE_RAW_WIDTH ? reader->readSingle()
+		                                            : reader->readVarInt32() / COMPACT_LANE_STEPS;
+		if (flags & COMPACT_NOTE_LAYER)
+			note.layer = reader->readVarUInt32();
+
+		if (!note.hasEase())
+			note.flick = (FlickType)(flags >> COMPACT_NOTE_FLICK_SHIFT);
+
+		note.critical = (bool)(flags & COMPACT_NOTE_CRITICAL);
+		note.friction = (bool)(flags & COMPACT_NOTE_FRICTION);
+		return note;
+	}
+
+	void writeCompactNote(const Note& note, BinaryWriter* writer, int& previousTick)
+	{
+		int32_t laneSteps{}, widthSteps{};
+		const bool rawLane = !toLaneSteps(note.lane, laneSteps);
+		const bool rawWidth = !toLaneSteps(note.width, widthSteps);
+
+		uint8_t flags{};
+		if (note.critical)
+			flags |= COMPACT_NOTE_CRITICAL;
+		if (note.friction)
+			flags |= COMPACT_NOTE_FRICTION;
+		if (rawLane)
+			flags |= COMPACT_NOTE_RAW_LANE;
+		if (rawWidth)
+			flags |= COMPACT_NOTE_RAW_WIDTH;
+		if (note.layer)
+			flags |= COMPACT_NOTE_LAYER;
+		if (!note.hasEase())
+			flags |= (uint8_t)note.flick << COMPACT_NOTE_FLICK_SHIFT;
+
+		writer->writeUInt8(flags);
+		writer->writeVarInt32(note.tick - previousTick);
+		previousTick = note.tick;
+
+		if (rawLane)
+			writer->writeSingle(note.lane);
+		else
+			writer->writeVarInt32(laneSteps);
+
+		if (rawWidth)
+			writer->writeSingle(note.width);
+		else
+			writer->writeVarInt32(widthSteps);
+
+		if (note.layer)
+			writer->writeVarUInt32(note.layer);
+	}
+
+	// Notes of the taps or damages section in the order they are written
+	static std::vector<const Note*> getSectionNotes(const Score& score, NoteType type, bool compact)
+	{
+		std::vector<const Note*> notes;
+		for (const auto& [id, note] : score.notes)
+			if (note.getType() == type)
+				notes.push_back(&note);
+
+		// Sorting keeps the tick deltas of the compact encoding small
+		if (compact)
+			std::stable_sort(notes.begin(), notes.end(),
+			                 [](const Note* a, const Note* b) { return a->tick < b->tick; });
+
+		return notes;
+	}
+
+	// Holds of the holds section in the order they are written
+	static std::vector<const HoldNote*> getSectionHolds(const Score& score, bool compact)
+	{
+		std::vector<const HoldNote*> holds;
+		holds.reserve(score.holdNotes.size());
+		for (const auto& [id, hold] : score.holdNotes)
+			holds.push_back(&hold);
+
+		if (compact)
+			std::stable_sort(holds.begin(), holds.end(),
+			                 [&score](const HoldNote* a, const HoldNote* b) {
+				                 return score.notes.at(a->start.ID).tick <
+				                        score.notes.at(b->start.ID).tick;
+			                 });
+
+		return holds;
+	}
+
 	ScoreMetadata readMetadata(BinaryReader* reader, int version, int cyanvasVersion)
 	{
 		ScoreMetadata metadata;
@@ -116,37 +240,35 @@ namespace MikuMikuWorld
 		writer->writeInt32(metadata.laneExtension);
 	}
 
-	void readScoreEvents(Score& score, int version, int cyanvasVersion, BinaryReader* reader)
+	ScoreEvents readScoreEvents(BinaryReader* reader, int version, int cyanvasVersion)
 	{
+		ScoreEvents events;
+
 		// time signature
 		int timeSignatureCount = reader->readUInt32();
-		if (timeSignatureCount)
-			score.timeSignatures.clear();
-
 		for (int i = 0; i < timeSignatureCount; ++i)
 		{
 			int measure = reader->readUInt32();
 			int numerator = reader->readUInt32();
 			int denominator = reader->readUInt32();
-			score.timeSignatures[measure] = { measure, numerator, denominator };
+			events.timeSignatures[measure] = { measure, numerator, denominator };
 		}
 
 		// bpm
 		int tempoCount = reader->readUInt32();
-		if (tempoCount)
-			score.tempoChanges.clear();
-
+		events.tempoChanges.reserve(tempoCount);
 		for (int i = 0; i < tempoCount; ++i)
 		{
 			int tick = reader->readUInt32();
 			float bpm = reader->readSingle();
-			score.tempoChanges.push_back({ tick, bpm });
+			events.tempoChanges.push_back({ tick, bpm });
 		}
 
 		// hi-speed
 		if (version > 2)
 		{
 			int hiSpeedCount = reader->readUInt32();
+			events.hiSpeedChanges.reserve(hiSpeedCount);
 			for (int i = 0; i < hiSpeedCount; ++i)
 			{
 				int tick = reader->readUInt32();
@@ -154,8 +276,7 @@ namespace MikuMikuWorld
 				int layer = 0;
 				if (cyanvasVersion >= 4)
 					layer = reader->readUInt32();
-				int id = nextHiSpeedID++;
-				score.hiSpeedChanges[id] = HiSpeedChange{ id, tick, speed, layer };
+				events.hiSpeedChanges.push_back(HiSpeedChange{ 0, tick, speed, layer });
 			}
 		}
 
@@ -163,15 +284,15 @@ namespace MikuMikuWorld
 		if (version > 1)
 		{
 			int skillCount = reader->readUInt32();
+			events.skillTicks.reserve(skillCount);
 			for (int i = 0; i < skillCount; ++i)
-			{
-				int tick = reader->readUInt32();
-				score.skills.push_back({ nextSkillID++, tick });
-			}
+				events.skillTicks.push_back(reader->readUInt32());
 
-			score.fever.startTick = reader->readUInt32();
-			score.fever.endTick = reader->readUInt32();
+			events.fever.startTick = reader->readUInt32();
+			events.fever.endTick = reader->readUInt32();
 		}
+
+		return events;
 	}
 
 	void writeScoreEvents(const Score& score, BinaryWriter* writer)
@@ -209,125 +330,201 @@ namespace MikuMikuWorld
 		writer->writeInt32(score.fever.endTick);
 	}
 
-	Score deserializeScore(const std::string& filename)
+	// Versions and section addresses of a MMWS file. Versions before 3 have no addresses and
+	// store the sections one after another
+	struct ScoreFileHeader
 	{
-		Score score;
-		BinaryReader reader(filename);
-		if (!reader.isStreamValid())
-			return score;
+		int version{};
+		int cyanvasVersion{};
+		uint32_t metadataAddress{};
+		uint32_t eventsAddress{};
+		uint32_t tapsAddress{};
+		uint32_t holdsAddress{};
+		uint32_t damagesAddress{};
+		uint32_t layersAddress{};
+		uint32_t waypointsAddress{};
+
+		// Compact sections store ticks relative to the previous note and small values in a byte
+		bool isCompact() const { return cyanvasVersion >= COMPACT_CYANVAS_VERSION; }
+	};
 
+	static ScoreFileHeader readScoreFileHeader(BinaryReader& reader)
+	{
 		std::string signature = reader.readString();
 		if (signature != "MMWS" && signature != "CCMMWS")
 			throw std::runtime_error("Not a MMWS file.");
 
 		bool isCyanvas = signature == "CCMMWS";
 
-		int version = reader.readUInt16();
-		int cyanvasVersion = reader.readUInt16();
-		if (isCyanvas && cyanvasVersion == 0)
+		ScoreFileHeader header;
+		header.version = reader.readUInt16();
+		header.cyanvasVersion = reader.readUInt16();
+		if (isCyanvas && header.cyanvasVersion == 0)
 		{
-			cyanvasVersion = 1;
+			header.cyanvasVersion = 1;
 		}
 
-		uint32_t metadataAddress{};
-		uint32_t eventsAddress{};
-		uint32_t tapsAddress{};
-		uint32_t holdsAddress{};
-		uint32_t damagesAddress{};
-		uint32_t layersAddress{};
-		uint32_t waypointsAddress{};
-		if (version > 2)
+		if (header.version > 2)
 		{
-			metadataAddress = reader.readUInt32();
-			eventsAddress = reader.readUInt32();
-			tapsAddress = reader.readUInt32();
-			holdsAddress = reader.readUInt32();
+			header.metadataAddress = reader.readUInt32();
+			header.eventsAddress = reader.readUInt32();
+			header.tapsAddress = reader.readUInt32();
+			header.holdsAddress = reader.readUInt32();
 			if (isCyanvas)
-				damagesAddress = reader.readUInt32();
-			if (cyanvasVersion >= 4)
-				layersAddress = reader.readUInt32();
-			if (cyanvasVersion >= 5)
-				waypointsAddress = reader.readUInt32();
+				header.damagesAddress = reader.readUInt32();
+			if (header.cyanvasVersion >= 4)
+				header.layersAddress = reader.readUInt32();
+			if (header.cyanvasVersion >= 5)
+				header.waypointsAddress = reader.readUInt32();
+		}
 
-			reader.seek(metadataAddress);
+		return header;
+	}
+
+	static Note readSectionNote(NoteType type, BinaryReader& reader, const ScoreFileHeader& header,
+	                            int& previousTick)
+	{
+		return header.isCompact() ? readCompactNote(type, &reader, previousTick)
+		                          : readNote(type, &reader, header.cyanvasVersion);
+	}
+
+	static uint32_t readSectionValue(BinaryReader& reader, const ScoreFileHeader& header)
+	{
+		return header.isCompact() ? reader.readUInt8() : reader.readUInt32();
+	}
+
+	// Reads the next hold of the holds section. IDs of the hold and its notes are left unassigned
+	static HoldNote readSectionHold(BinaryReader& reader, const ScoreFileHeader& header,
+	                                int& previousTick, Note& start, std::vector<Note>& steps,
+	                                Note& end)
+	{
+		HoldNote hold;
+
+		unsigned int flags{};
+		if (header.version > 3)
+			flags = readSectionValue(reader, header);
+
+		if (flags & HOLD_START_HIDDEN)
+			hold.startType = HoldNoteType::Hidden;
+
+		if (flags & HOLD_END_HIDDEN)
+			hold.endType = HoldNoteType::Hidden;
+
+		if (flags & HOLD_GUIDE)
+			hold.startType = hold.endType = HoldNoteType::Guide;
+
+		start = readSectionNote(NoteType::Hold, reader, header, previousTick);
+		hold.start.ease = (EaseType)readSectionValue(reader, header);
+		if (header.cyanvasVersion >= 2)
+		{
+			hold.fadeType = (FadeType)readSectionValue(reader, header);
+		}
+		if (header.cyanvasVersion >= 3)
+		{
+			hold.guideColor = (GuideColor)readSectionValue(reader, header);
+		}
+		else
+		{
+			hold.guideColor = start.critical ? GuideColor::Yellow : GuideColor::Green;
 		}
 
+		// Notes of a hold are relative to the previous note of the same hold
+		int holdTick = start.tick;
+		int stepCount = header.isCompact() ? reader.readVarUInt32() : reader.readUInt32();
+		steps.clear();
+		hold.steps.reserve(stepCount);
+		for (int i = 0; i < stepCount; ++i)
+		{
+			steps.push_back(readSectionNote(NoteType::HoldMid, reader, header, holdTick));
+
+			HoldStep step{};
+			step.type = (HoldStepType)readSectionValue(reader, header);
+			step.ease = (EaseType)readSectionValue(reader, header);
+			hold.steps.push_back(step);
+		}
+
+		end = readSectionNote(NoteType::HoldEnd, reader, header, holdTick);
+		return hold;
+	}
+
+	Score deserializeScore(const std::string& filename)
+	{
+		Score score;
+		BinaryReader reader(filename);
+		if (!reader.isStreamValid())
+			return score;
+
+		const ScoreFileHeader header = readScoreFileHeader(reader);
+		const int version = header.version;
+		const int cyanvasVersion = header.cyanvasVersion;
+
+		if (version > 2)
+			reader.seek(header.metadataAddress);
+
 		score.metadata = readMetadata(&reader, version, cyanvasVersion);
 
 		if (version > 2)
-			reader.seek(eventsAddress);
+			reader.seek(header.eventsAddress);
+
+		ScoreEvents events = readScoreEvents(&reader, version, cyanvasVersion);
+		if (!events.timeSignatures.empty())
+			score.timeSignatures = std::move(events.timeSignatures);
+
+		if (!events.tempoChanges.empty())
+			score.tempoChanges = std::move(events.tempoChanges);
 
-		readScoreEvents(score, version, cyanvasVersion, &reader);
+		for (HiSpeedChange& hiSpeed : events.hiSpeedChanges)
+		{
+			hiSpeed.ID = nextHiSpeedID++;
+			score.hiSpeedChanges[hiSpeed.ID] = hiSpeed;
+		}
+
+		for (int tick : events.skillTicks)
+			score.skills.push_back({ nextSkillID++, tick });
+
+		if (version > 1)
+			score.fever = events.fever;
 
 		if (version > 2)
-			reader.seek(tapsAddress);
+			reader.seek(header.tapsAddress);
 
+		int previousTick = 0;
 		int noteCount = reader.readUInt32();
 		score.notes.reserve(noteCount);
 		for (int i = 0; i < noteCount; ++i)
 		{
-			Note note = readNote(NoteType::Tap, &reader, cyanvasVersion);
+			Note note = readSectionNote(NoteType::Tap, reader, header, previousTick);
 			note.ID = nextID++;
 			score.notes[note.ID] = note;
 		}
 
 		if (version > 2)
-			reader.seek(holdsAddress);
+			reader.seek(header.holdsAddress);
 
+		previousTick = 0;
 		int holdCount = reader.readUInt32();
 		score.holdNotes.reserve(holdCount);
+
+		Note start, end;
+		std::vector<Note> steps;
 		for (int i = 0; i < holdCount; ++i)
 		{
-			HoldNote hold;
+			HoldNote hold = readSectionHold(reader, header, previousTick, start, steps, end);
 
-			unsigned int flags{};
-			if (version > 3)
-				flags = reader.readUInt32();
-
-			if (flags & HOLD_START_HIDDEN)
-				hold.startType = HoldNoteType::Hidden;
-
-			if (flags & HOLD_END_HIDDEN)
-				hold.endType = HoldNoteType::Hidden;
-
-			if (flags & HOLD_GUIDE)
-				hold.startType = hold.endType = HoldNoteType::Guide;
-
-			Note start = readNote(NoteType::Hold, &reader, cyanvasVersion);
+			// IDs follow the order the notes were written in
 			start.ID = nextID++;
-			hold.start.ease = (EaseType)reader.readUInt32();
 			hold.start.ID = start.ID;
-			if (cyanvasVersion >= 2)
-			{
-				hold.fadeType = (FadeType)reader.readUInt32();
-			}
-			if (cyanvasVersion >= 3)
-			{
-				hold.guideColor = (GuideColor)reader.readUInt32();
-			}
-			else
-			{
-				hold.guideColor = start.critical ? GuideColor::Yellow : GuideColor::Green;
-			}
 			score.notes[start.ID] = start;
 
-			int stepCount = reader.readUInt32();
-			hold.steps.reserve(stepCount);
-			for (int i = 0; i < stepCount; ++i)
+			for (size_t step = 0; step < steps.size(); ++step)
 			{
-				Note mid = readNote(NoteType::HoldMid, &reader, cyanvasVersion);
+				Note& mid = steps[step];
 				mid.ID = nextID++;
 				mid.parentID = start.ID;
+				hold.steps[step].ID = mid.ID;
 				score.notes[mid.ID] = mid;
-
-				HoldStep step{};
-				step.type = (HoldStepType)reader.readUInt32();
-				step.ease = (EaseType)reader.readUInt32();
-				step.ID = mid.ID;
-				hold.steps.push_back(step);
 			}
 
-			Note end = readNote(NoteType::HoldEnd, &reader, cyanvasVersion);
 			end.ID = nextID++;
 			end.parentID = start.ID;
 			score.notes[end.ID] = end;
@@ -338,13 +535,14 @@ namespace MikuMikuWorld
 
 		if (cyanvasVersion >= 1)
 		{
-			reader.seek(damagesAddress);
+			reader.seek(header.damagesAddress);
 
+			previousTick = 0;
 			int damageCount = reader.readUInt32();
 			score.notes.reserve(damageCount);
 			for (int i = 0; i < damageCount; ++i)
 			{
-				Note note = readNote(NoteType::Damage, &reader, cyanvasVersion);
+				Note note = readSectionNote(NoteType::Damage, reader, header, previousTick);
 				note.ID = nextID++;
 				score.notes[note.ID] = note;
 			}
@@ -353,7 +551,7 @@ namespace MikuMikuWorld
 		if (cyanvasVersion >= 4)
 		{
 			score.layers.clear();
-			reader.seek(layersAddress);
+			reader.seek(header.layersAddress);
 
 			int layerCount = reader.readUInt32();
 			score.layers.reserve(layerCount);
@@ -367,7 +565,7 @@ namespace MikuMikuWorld
 		if (cyanvasVersion >= 5)
 		{
 			score.waypoints.clear();
-			reader.seek(waypointsAddress);
+			reader.seek(header.waypointsAddress);
 
 			int waypointCount = reader.readUInt32();
 			score.waypoints.reserve(waypointCount);
@@ -383,11 +581,118 @@ namespace MikuMikuWorld
 		return score;
 	}
 
-	void serializeScore(const Score& score, const std::string& filename)
+	// Header, metadata and events of current files fit in this, larger ones are loaded again
+	constexpr size_t SCORE_SUMMARY_PREFIX_SIZE = 16 * 1024;
+
+	static void readSummarySections(BinaryReader& reader, const ScoreFileHeader& header,
+	                                int sections, ScoreSummary& summary)
+	{
+		const int version = header.version;
+		const int cyanvasVersion = header.cyanvasVersion;
+
+		// Versions without addresses have to read every section before the requested ones
+		if (version > 2)
+			reader.seek(header.metadataAddress);
+
+		if (sections & SCORE_SUMMARY_METADATA || version <= 2)
+			summary.metadata = readMetadata(&reader, version, cyanvasVersion);
+
+		if (!(sections & (SCORE_SUMMARY_EVENTS | SCORE_SUMMARY_NOTE_COUNTS)))
+			return;
+
+		if (version > 2)
+			reader.seek(header.eventsAddress);
+
+		if (sections & SCORE_SUMMARY_EVENTS || version <= 2)
+			summary.events = readScoreEvents(&reader, version, cyanvasVersion);
+
+		if (!(sections & SCORE_SUMMARY_NOTE_COUNTS))
+			return;
+
+		auto countNote = [&summary](const Note& note)
+		{
+			const bool flick = note.flick != FlickType::None && !note.hasEase();
+			summary.taps += note.getType() == NoteType::Tap && !flick && !note.friction;
+			summary.holds += note.getType() == NoteType::Hold;
+			summary.steps += note.getType() == NoteType::HoldMid;
+			summary.damages += note.getType() == NoteType::Damage;
+			summary.flicks += flick;
+			summary.traces += note.friction;
+			summary.total++;
+		};
+
+		if (version > 2)
+			reader.seek(header.tapsAddress);
+
+		int previousTick = 0;
+		int noteCount = reader.readUInt32();
+		for (int i = 0; i < noteCount; ++i)
+			countNote(readSectionNote(NoteType::Tap, reader, header, previousTick));
+
+		if (version > 2)
+			reader.seek(header.holdsAddress);
+
+		previousTick = 0;
+		int holdCount = reader.readUInt32();
+
+		Note start, end;
+		std::vector<Note> steps;
+		for (int i = 0; i < holdCount; ++i)
+		{
+			readSectionHold(reader, header, previousTick, start, steps, end);
+			countNote(start);
+			for (const Note& step : steps)
+				countNote(step);
+
+			countNote(end);
+		}
+
+		if (cyanvasVersion >= 1)
+		{
+			reader.seek(header.damagesAddress);
+
+			previousTick = 0;
+			int damageCount = reader.readUInt32();
+			for (int i = 0; i < damageCount; ++i)
+				countNote(readSectionNote(NoteType::Damage, reader, header, previousTick));
+		}
+	}
+
+	ScoreSummary readScoreSummary(const std::string& filename, int sections)
+	{
+		// Metadata and events come before the notes, so counting notes is the only reason to load
+		// the whole file
+		const size_t loadSize =
+		    sections & SCORE_SUMMARY_NOTE_COUNTS ? SIZE_MAX : SCORE_SUMMARY_PREFIX_SIZE;
+
+		BinaryReader reader(filename, loadSize);
+		if (!reader.isStreamValid())
+			throw std::runtime_error("Failed to open the file for reading.");
+
+		ScoreSummary summary;
+		const ScoreFileHeader header = readScoreFileHeader(reader);
+		summary.version = header.version;
+		summary.cyanvasVersion = header.cyanvasVersion;
+
+		const size_t requiredSize = header.version > 2 ? header.tapsAddress : SIZE_MAX;
+		if (reader.getFileSize() < loadSize || requiredSize <= loadSize)
+		{
+			readSummarySections(reader, header, sections, summary);
+		}
+		else
+		{
+			BinaryReader prefixReader(filename, requiredSize);
+			readSummarySections(prefixReader, header, sections, summary);
+		}
+
+		return summary;
+	}
+
+	void serializeScore(const Score& score, const std::string& filename, bool compact)
 	{
 		BinaryWriter writer(filename);
 		if (!writer.isStreamValid())
-			return;
+			throw std::runtime_error("Failed to open the file for writing.");
 
 		// signature
 		writer.writeString("CCMMWS");
@@ -395,7 +700,7 @@ namespace MikuMikuWorld
 		// version
 		writer.writeInt16(4);
 		// cyanvas version
-		writer.writeInt16(6);
+		writer.writeInt16(compact ? COMPACT_CYANVAS_VERSION : 6);
 
 		// offsets address in order: metadata -> events -> taps -> holds
 		// Cyanvas extension: -> damages -> layers -> waypoints
@@ -408,85 +713,85 @@ namespace MikuMikuWorld
 		uint32_t eventsAddress = writer.getStreamPosition();
 		writeScoreEvents(score, &writer);
 
-		uint32_t tapsAddress = writer.getStreamPosition();
-		writer.writeNull(sizeof(uint32_t));
-
-		int noteCount = 0;
-		for (const auto& [id, note] : score.notes)
+		auto writeSectionNote = [&](const Note& note, int& previousTick)
 		{
-			if (note.getType() != NoteType::Tap)
-				continue;
-
-			writeNote(note, &writer);
-			++noteCount;
-		}
+			if (compact)
+				writeCompactNote(note, &writer, previousTick);
+			else
+				writeNote(note, &writer);
+		};
+		auto writeSectionValue = [&](uint32_t value)
+		{
+			if (compact)
+				writer.writeUInt8(value);
+			else
+				writer.writeInt32(value);
+		};
 
-		uint32_t holdsAddress = writer.getStreamPosition();
+		uint32_t tapsAddress = writer.getStreamPosition();
+		std::vector<const Note*> taps = getSectionNotes(score, NoteType::Tap, compact);
+		writer.writeInt32(taps.size());
 
-		// write taps count
-		writer.seek(tapsAddress);
-		writer.writeInt32(noteCount);
+		int previousTick = 0;
+		for (const Note* note : taps)
+			writeSectionNote(*note, previousTick);
 
-		writer.seek(holdsAddress);
+		uint32_t holdsAddress = writer.getStreamPosition();
 
-		writer.writeInt32(score.holdNotes.size());
-		for (const auto& [id, hold] : score.holdNotes)
+		previousTick = 0;
+		std::vector<const HoldNote*> holds = getSectionHolds(score, compact);
+		writer.writeInt32(holds.size());
+		for (const HoldNote* hold : holds)
 		{
 			unsigned int flags{};
-			if (hold.startType == HoldNoteType::Guide)
+			if (hold->startType == HoldNoteType::Guide)
 				flags |= HOLD_GUIDE;
-			if (hold.startType == HoldNoteType::Hidden)
+			if (hold->startType == HoldNoteType::Hidden)
 				flags |= HOLD_START_HIDDEN;
-			if (hold.endType == HoldNoteType::Hidden)
+			if (hold->endType == HoldNoteType::Hidden)
 				flags |= HOLD_END_HIDDEN;
-			writer.writeInt32(flags);
+			writeSectionValue(flags);
 
 			// note data
-			const Note& start = score.notes.at(hold.start.ID);
-			writeNote(start, &writer);
-			writer.writeInt32((int)hold.start.ease);
-			writer.writeInt32((int)hold.fadeType);
-			writer.writeInt32((int)hold.guideColor);
+			const Note& start = score.notes.at(hold->start.ID);
+			writeSectionNote(start, previousTick);
+			writeSectionValue((int)hold->start.ease);
+			writeSectionValue((int)hold->fadeType);
+			writeSectionValue((int)hold->guideColor);
 
 			// steps
-			int stepCount = hold.steps.size();
-			writer.writeInt32(stepCount);
-			for (const auto& step : hold.steps)
+			int holdTick = start.tick;
+			int stepCount = hold->steps.size();
+			if (compact)
+				writer.writeVarUInt32(stepCount);
+			else
+				writer.writeInt32(stepCount);
+
+			for (const auto& step : hold->steps)
 			{
 				const Note& mid = score.notes.at(step.ID);
-				writeNote(mid, &writer);
-				writer.writeInt32((int)step.type);
-				writer.writeInt32((int)step.ease);
+				writeSectionNote(mid, holdTick);
+				writeSectionValue((int)step.type);
+				writeSectionValue((int)step.ease);
 			}
 
 			// end
-			const Note& end = score.notes.at(hold.end);
-			writeNote(end, &writer);
+			const Note& end = score.notes.at(hold->end);
+			writeSectionNote(end, holdTick);
 		}
 
 		uint32_t damagesAddress = writer.getStreamPosition();
-		writer.writeNull(sizeof(uint32_t));
 
 		// Cyanvas extension: write damages
-		int damageNoteCount = 0;
-		for (const auto& [id, note] : score.notes)
-		{
-			if (note.getType() != NoteType::Damage)
-				continue;
-
-			writeNote(note, &writer);
-			++damageNoteCount;
-		}
+		previousTick = 0;
+		std::vector<const Note*> damages = getSectionNotes(score, NoteType::Damage, compact);
+		writer.writeInt32(damages.size());
+		for (const Note* note : damages)
+			writeSectionNote(*note, previousTick);
 
 		// Cyanvas extension: write layers
 		uint32_t layersAddress = writer.getStreamPosition();
 
-		// write damages count
-		writer.seek(damagesAddress);
-		writer.writeInt32(damageNoteCount);
-
-		writer.seek(layersAddress);
-
 		writer.writeInt32(score.layers.size());
 
 		for (const auto& layer : score.layers)
@@ -513,7 +818,34 @@ namespace MikuMikuWorld
 		writer.writeInt32(layersAddress);
 		writer.writeInt32(waypointsAddress);
 
-		writer.flush();
-		writer.close();
+		// Writes the whole file at once and moves it over the previous one
+		if (!writer.close())
+			throw std::runtime_error("Failed to write the file.");
+	}
+
+	void getSerializationOrder(const Score& score, std::vector<int>& noteIDs,
+	                           std::vector<int>& hiSpeedIDs, bool compact)
+	{
+		noteIDs.clear();
+		noteIDs.reserve(score.notes.size());
+		for (const Note* note : getSectionNotes(score, NoteType::Tap, compact))
+			noteIDs.push_back(note->ID);
+
+		for (const HoldNote* hold : getSectionHolds(score, compact))
+		{
+			noteIDs.push_back(hold->start.ID);
+			for (const auto& step : hold->steps)
+				noteIDs.push_back(step.ID);
+
+			noteIDs.push_back(hold->end);
+		}
+
+		for (const Note* note : getSectionNotes(score, NoteType::Damage, compact))
+			noteIDs.push_back(note->ID);
+
+		hiSpeedIDs.clear();
+		hiSpeedIDs.reserve(score.hiSpeedChanges.size());
+		for (const auto& [id, hiSpeed] : score.hiSpeedChanges)
+			hiSpeedIDs.push_back(id);
 	}
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include "CopyOnWrite.h"
 #include "Note.h"
 #include "Tempo.h"
 #include <map>
@@ -8,8 +9,8 @@
 
 namespace MikuMikuWorld
 {
-	extern int nextSkillID;
-	extern int nextHiSpeedID;
+	extern thread_local int nextSkillID;
+	extern thread_local int nextHiSpeedID;
 
 	struct SkillTrigger
 	{
@@ -58,11 +59,12 @@ namespace MikuMikuWorld
 	struct Score
 	{
 		ScoreMetadata metadata;
-		std::unordered_map<int, Note> notes;
-		std::unordered_map<int, HoldNote> holdNotes;
-		std::vector<Tempo> tempoChanges;
+		// Large containers are shared between copies of the score until modified
+		CopyOnWrite<std::unordered_map<int, Note>> notes;
+		CopyOnWrite<std::unordered_map<int, HoldNote>> holdNotes;
+		CopyOnWrite<std::vector<Tempo>> tempoChanges;
 		std::map<int, TimeSignature> timeSignatures;
-		std::unordered_map<int, HiSpeedChange> hiSpeedChanges;
+		CopyOnWrite<std::unordered_map<int, HiSpeedChange>> hiSpeedChanges;
 		std::vector<SkillTrigger> skills;
 		Fever fever;
 
@@ -72,6 +74,66 @@ namespace MikuMikuWorld
 		Score();
 	};
 
+	// Events of a score file as they are stored, without IDs
+	struct ScoreEvents
+	{
+		std::map<int, TimeSignature> timeSignatures;
+		std::vector<Tempo> tempoChanges;
+		std::vector<HiSpeedChange> hiSpeedChanges;
+		std::vector<int> skillTicks;
+		Fever fever{ -1, -1 };
+	};
+
+	// Sections of a MMWS file read by `readScoreSummary`
+	enum ScoreSummarySections
+	{
+		SCORE_SUMMARY_METADATA = 1 << 0,
+		SCORE_SUMMARY_EVENTS = 1 << 1,
+		SCORE_SUMMARY_NOTE_COUNTS = 1 << 2,
+		SCORE_SUMMARY_ALL = SCORE_SUMMARY_METADATA | SCORE_SUMMARY_EVENTS | SCORE_SUMMARY_NOTE_COUNTS
+	};
+
+	// Overview of a MMWS file for listing charts without loading them
+	struct ScoreSummary
+	{
+		int version{};
+		int cyanvasVersion{};
+		ScoreMetadata metadata{};
+		ScoreEvents events{};
+
+		// Note counts, categorized the same way as `ScoreStats`
+		int taps{};
+		int flicks{};
+		int holds{};
+		int steps{};
+		int traces{};
+		int damages{};
+		int total{};
+	};
+
 	Score deserializeScore(const std::string& filename);
-	void serializeScore(const Score& score, const std::string& filename);
+
+	/**
+	 * @brief Reads only the requested sections of a MMWS file without building its notes
+	 * @param sections Combination of `ScoreSummarySections`. Without note counts only the start of
+	 *                 the file up to the notes is loaded
+	 * @note Does not modify the global ID counters, so it can be used while a score is open
+	 * @throw `std::runtime_error` if the file could not be opened or is not a MMWS file
+	 */
+	ScoreSummary readScoreSummary(const std::string& filename, int sections = SCORE_SUMMARY_ALL);
+
+	/**
+	 * @brief Writes the score to a MMWS file
+	 * @param compact Writes notes sorted by tick with delta encoded ticks and packed fields.
+	 *                Files written this way cannot be opened by versions before cyanvas version 7
+	 */
+	void serializeScore(const Score& score, const std::string& filename, bool compact = false);
+
+	/**
+	 * @brief Lists the IDs of notes and hi-speed changes in the order `serializeScore` writes them
+	 * @note `deserializeScore` assigns increasing IDs in the same order, which lets IDs of the
+	 *       written score be matched with the IDs of the loaded one
+	 */
+	void getSerializationOrder(const Score& score, std::vector<int>& noteIDs,
+	                           std::vector<int>& hiSpeedIDs, bool compact = false);
 }
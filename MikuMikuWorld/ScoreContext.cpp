@@ -1,4 +1,5 @@
 #include "ScoreContext.h"
+#include "ApplicationConfiguration.h"
 #include "Constants.h"
 #include "IO.h"
 #include "UI.h"
@@ -1252,7 +1253,10 @@ namespace MikuMikuWorld
 	{
 		if (history.hasUndo())
 		{
-			score = history.undo();
+			noteColumns.apply(history.undo(score).notes, false);
+			invalidateIndices();
+			tempoMap.invalidate();
+			measureTable.invalidate();
 			clearSelection();
 
 			UI::setWindowTitle((workingData.filename.size()
@@ -1261,7 +1265,7 @@ namespace MikuMikuWorld
 			                   "*");
 			upToDate = false;
 
-			scoreStats.calculateStats(score);
+			updateStats();
 		}
 	}
 
@@ -1269,7 +1273,10 @@ namespace MikuMikuWorld
 	{
 		if (history.hasRedo())
 		{
-			score = history.redo();
+			noteColumns.apply(history.redo(score).notes, true);
+			invalidateIndices();
+			tempoMap.invalidate();
+			measureTable.invalidate();
 			clearSelection();
 
 			UI::setWindowTitle((workingData.filename.size()
@@ -1278,18 +1285,25 @@ namespace MikuMikuWorld
 			                   "*");
 			upToDate = false;
 
-			scoreStats.calculateStats(score);
+			updateStats();
 		}
 	}
 
 	void ScoreContext::pushHistory(std::string description, const Score& prev, const Score& curr)
 	{
-		history.pushHistory(description, prev, curr);
+		history.setMemoryLimit(static_cast<size_t>(std::max(config.historyMemoryLimit, 0)) *
+		                       1024 * 1024);
+		history.setMergeSameDescription(config.mergeHistoryEntries);
+
+		ScoreDelta delta = ScoreDelta::between(prev, curr);
+		noteColumns.apply(delta.notes, true);
+		history.pushHistory(History{ std::move(description), std::move(delta) });
+		invalidateIndices();
 
 		UI::setWindowTitle((workingData.filename.size() ? File::getFilename(workingData.filename)
 		                                                : windowUntitled) +
 		                   "*");
-		scoreStats.calculateStats(score);
+		updateStats();
 
 		upToDate = false;
 	}
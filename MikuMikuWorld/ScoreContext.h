@@ -3,9 +3,12 @@
 #include "Audio/Waveform.h"
 #include "Constants.h"
 #include "HistoryManager.h"
+#include "HoldCurveCache.h"
 #include "Jacket.h"
 #include "JsonIO.h"
+#include "NoteColumns.h"
 #include "Score.h"
+#include "ScoreIndex.h"
 #include "ScoreStats.h"
 #include "TimelineMode.h"
 #include <unordered_set>
@@ -73,6 +76,16 @@ namespace MikuMikuWorld
 		Score score;
 		EditorScoreData workingData;
 		ScoreStats scoreStats;
+		// Updated by pushHistory, undo and redo, must be invalidated whenever the score is replaced
+		NoteColumns noteColumns;
+		NoteTickIndex noteIndex;
+		HoldIntervalIndex holdIndex;
+		HoldCurveCache holdCurves;
+		HiSpeedTimeline hiSpeedTimeline;
+		// Must be invalidated whenever tempo changes are added, removed or edited
+		TempoMap tempoMap{ TICKS_PER_BEAT };
+		// Must be invalidated whenever time signatures are added, removed or edited
+		MeasureTable measureTable{ TICKS_PER_BEAT };
 		HistoryManager history;
 		Audio::AudioManager audio;
 		PasteData pasteData{};
@@ -119,9 +132,9 @@ namespace MikuMikuWorld
 			return holds;
 		}
 
-		double getTimeAtCurrentTick() const
+		double getTimeAtCurrentTick()
 		{
-			return accumulateDuration(currentTick, TICKS_PER_BEAT, score.tempoChanges);
+			return tempoMap.ticksToSeconds(currentTick, score.tempoChanges);
 		}
 
 		bool selectionHasEase() const;
@@ -142,6 +155,27 @@ namespace MikuMikuWorld
 				selectedNotes.insert(it.first);
 		}
 		inline void clearSelection() { selectedNotes.clear(); }
+		// Must be called after notes, holds or hi-speed changes are added, removed or moved
+		inline void invalidateIndices()
+		{
+			noteIndex.invalidate();
+			holdIndex.invalidate();
+			hiSpeedTimeline.invalidate();
+			// Cached curves check their own notes, only the removed holds need to go
+			holdCurves.prune(score);
+		}
+		// Cheaper than invalidateIndices when notes were only moved, as while dragging them
+		inline void updateIndices(const std::unordered_set<int>& movedNotes)
+		{
+			noteIndex.update(score, movedNotes);
+			holdIndex.update(score, movedNotes);
+		}
+
+		inline void updateStats()
+		{
+			noteColumns.update(score.notes);
+			scoreStats.calculateStats(score, noteColumns);
+		}
 
 		void setStep(HoldStepType step);
 		void setFlick(FlickType flick);
@@ -0,0 +1,294 @@
+#include "ScoreDelta.h"
+#include <algorithm>
+
+namespace MikuMikuWorld
+{
+	static bool equals(const Note& a, const Note& b)
+	{
+		return a.getType() == b.getType() && a.ID == b.ID && a.parentID == b.parentID &&
+		       a.tick == b.tick && a.lane == b.lane && a.width == b.width &&
+		       a.critical == b.critical && a.friction == b.friction && a.flick == b.flick &&
+		       a.layer == b.layer;
+	}
+
+	static bool equals(const HoldStep& a, const HoldStep& b)
+	{
+		return a.ID == b.ID && a.type == b.type && a.ease == b.ease;
+	}
+
+	static bool equals(const HoldNote& a, const HoldNote& b)
+	{
+		return equals(a.start, b.start) && a.end == b.end && a.startType == b.startType &&
+		       a.endType == b.endType && a.fadeType == b.fadeType &&
+		       a.guideColor == b.guideColor &&
+		       std::equal(a.steps.begin(), a.steps.end(), b.steps.begin(), b.steps.end(),
+		                  [](const HoldStep& x, const HoldStep& y) { return equals(x, y); });
+	}
+
+	static bool equals(const HiSpeedChange& a, const HiSpeedChange& b)
+	{
+		return a.ID == b.ID && a.tick == b.tick && a.speed == b.speed && a.layer == b.layer;
+	}
+
+	static bool equals(const TimeSignature& a, const TimeSignature& b)
+	{
+		return a.measure == b.measure && a.numerator == b.numerator &&
+		       a.denominator == b.denominator;
+	}
+
+	static bool equals(const Tempo& a, const Tempo& b) { return a.tick == b.tick && a.bpm == b.bpm; }
+
+	static bool equals(const SkillTrigger& a, const SkillTrigger& b)
+	{
+		return a.ID == b.ID && a.tick == b.tick;
+	}
+
+	static bool equals(const Fever& a, const Fever& b)
+	{
+		return a.startTick == b.startTick && a.endTick == b.endTick;
+	}
+
+	static bool equals(const Layer& a, const Layer& b)
+	{
+		return a.name == b.name && a.hidden == b.hidden;
+	}
+
+	static bool equals(const Waypoint& a, const Waypoint& b)
+	{
+		return a.name == b.name && a.tick == b.tick;
+	}
+
+	static bool equals(const ScoreMetadata& a, const ScoreMetadata& b)
+	{
+		return a.title == b.title && a.artist == b.artist && a.author == b.author &&
+		       a.musicFile == b.musicFile && a.jacketFile == b.jacketFile &&
+		       a.musicOffset == b.musicOffset && a.laneExtension == b.laneExtension;
+	}
+
+	template <typename T>
+	static bool equals(const std::vector<T>& a, const std::vector<T>& b)
+	{
+		return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+		                  [](const T& x, const T& y) { return equals(x, y); });
+	}
+
+	template <typename Key, typename Value, typename Map>
+	static void diffMap(MapDelta<Key, Value>& delta, const Map& prev, const Map& curr)
+	{
+		for (const auto& [key, before] : prev)
+		{
+			auto it = curr.find(key);
+			if (it == curr.end())
+				delta.entries.push_back({ key, true, false, before, Value{} });
+			else if (!equals(before, it->second))
+				delta.entries.push_back({ key, true, true, before, it->second });
+		}
+
+		for (const auto& [key, after] : curr)
+		{
+			if (prev.find(key) == prev.end())
+				delta.entries.push_back({ key, false, true, Value{}, after });
+		}
+	}
+
+	template <typename Key, typename Value, typename Map>
+	static void applyMap(const MapDelta<Key, Value>& delta, Map& map, bool forward)
+	{
+		for (const auto& entry : delta.entries)
+		{
+			const bool exists = forward ? entry.existsAfter : entry.existedBefore;
+			if (exists)
+				map[entry.key] = forward ? entry.after : entry.before;
+			else
+				map.erase(entry.key);
+		}
+	}
+
+	template <typename T>
+	static void diffValue(ValueDelta<T>& delta, const T& prev, const T& curr)
+	{
+		if (equals(prev, curr))
+			return;
+
+		delta.changed = true;
+		delta.before = prev;
+		delta.after = curr;
+	}
+
+	template <typename T, typename Value>
+	static void applyValue(const ValueDelta<T>& delta, Value& value, bool forward)
+	{
+		if (delta.changed)
+			value = forward ? delta.after : delta.before;
+	}
+
+	template <typename Key, typename Value>
+	static void mergeMap(MapDelta<Key, Value>& delta, const MapDelta<Key, Value>& next)
+	{
+		std::unordered_map<Key, size_t> indices;
+		indices.reserve(delta.entries.size());
+		for (size_t i = 0; i < delta.entries.size(); ++i)
+			indices[delta.entries[i].key] = i;
+
+		for (const auto& entry : next.entries)
+		{
+			auto it = indices.find(entry.key);
+			if (it == indices.end())
+			{
+				delta.entries.push_back(entry);
+				continue;
+			}
+
+			auto& merged = delta.entries[it->second];
+			merged.existsAfter = entry.existsAfter;
+			merged.after = entry.after;
+		}
+
+		// Elements added by the first edit and removed by the second one leave no trace
+		delta.entries.erase(std::remove_if(delta.entries.begin(), delta.entries.end(),
+		                                   [](const auto& entry)
+		                                   { return !entry.existedBefore && !entry.existsAfter; }),
+		                    delta.entries.end());
+	}
+
+	template <typename T>
+	static void mergeValue(ValueDelta<T>& delta, const ValueDelta<T>& next)
+	{
+		if (!next.changed)
+			return;
+
+		if (!delta.changed)
+			delta.before = next.before;
+
+		delta.changed = true;
+		delta.after = next.after;
+	}
+
+	static size_t byteSize(const Note&) { return sizeof(Note); }
+
+	static size_t byteSize(const HoldNote& hold)
+	{
+		return sizeof(HoldNote) + hold.steps.capacity() * sizeof(HoldStep);
+	}
+
+	static size_t byteSize(const HiSpeedChange&) { return sizeof(HiSpeedChange); }
+
+	static size_t byteSize(const TimeSignature&) { return sizeof(TimeSignature); }
+
+	static size_t byteSize(const Tempo&) { return sizeof(Tempo); }
+
+	static size_t byteSize(const SkillTrigger&) { return sizeof(SkillTrigger); }
+
+	static size_t byteSize(const Fever&) { return sizeof(Fever); }
+
+	static size_t byteSize(const Layer& layer) { return sizeof(Layer) + layer.name.capacity(); }
+
+	static size_t byteSize(const Waypoint& waypoint)
+	{
+		return sizeof(Waypoint) + waypoint.name.capacity();
+	}
+
+	static size_t byteSize(const ScoreMetadata& metadata)
+	{
+		return sizeof(ScoreMetadata) + metadata.title.capacity() + metadata.artist.capacity() +
+		       metadata.author.capacity() + metadata.musicFile.capacity() +
+		       metadata.jacketFile.capacity();
+	}
+
+	template <typename T>
+	static size_t byteSize(const std::vector<T>& values)
+	{
+		size_t size = sizeof(values);
+		for (const T& value : values)
+			size += byteSize(value);
+
+		return size;
+	}
+
+	template <typename Key, typename Value>
+	static size_t byteSize(const MapDelta<Key, Value>& delta)
+	{
+		size_t size = sizeof(delta);
+		for (const auto& entry : delta.entries)
+			size += sizeof(entry) - 2 * sizeof(Value) + byteSize(entry.before) +
+			        byteSize(entry.after);
+
+		return size;
+	}
+
+	template <typename T>
+	static size_t byteSize(const ValueDelta<T>& delta)
+	{
+		return delta.changed ? sizeof(delta) + byteSize(delta.before) + byteSize(delta.after)
+		                     : sizeof(delta);
+	}
+
+	ScoreDelta ScoreDelta::between(const Score& prev, const Score& curr)
+	{
+		ScoreDelta delta;
+
+		// Containers still sharing storage were not touched since the snapshot was taken
+		if (!prev.notes.sharesWith(curr.notes))
+			diffMap(delta.notes, prev.notes, curr.notes);
+		if (!prev.holdNotes.sharesWith(curr.holdNotes))
+			diffMap(delta.holdNotes, prev.holdNotes, curr.holdNotes);
+		if (!prev.hiSpeedChanges.sharesWith(curr.hiSpeedChanges))
+			diffMap(delta.hiSpeedChanges, prev.hiSpeedChanges, curr.hiSpeedChanges);
+		if (!prev.tempoChanges.sharesWith(curr.tempoChanges))
+			diffValue(delta.tempoChanges, prev.tempoChanges.get(), curr.tempoChanges.get());
+
+		diffMap(delta.timeSignatures, prev.timeSignatures, curr.timeSignatures);
+		diffValue(delta.skills, prev.skills, curr.skills);
+		diffValue(delta.fever, prev.fever, curr.fever);
+		diffValue(delta.metadata, prev.metadata, curr.metadata);
+		diffValue(delta.layers, prev.layers, curr.layers);
+		diffValue(delta.waypoints, prev.waypoints, curr.waypoints);
+		return delta;
+	}
+
+	static void applyDelta(const ScoreDelta& delta, Score& score, bool forward)
+	{
+		applyMap(delta.notes, score.notes, forward);
+		applyMap(delta.holdNotes, score.holdNotes, forward);
+		applyMap(delta.hiSpeedChanges, score.hiSpeedChanges, forward);
+		applyMap(delta.timeSignatures, score.timeSignatures, forward);
+		applyValue(delta.tempoChanges, score.tempoChanges, forward);
+		applyValue(delta.skills, score.skills, forward);
+		applyValue(delta.fever, score.fever, forward);
+		applyValue(delta.metadata, score.metadata, forward);
+		applyValue(delta.layers, score.layers, forward);
+		applyValue(delta.waypoints, score.waypoints, forward);
+	}
+
+	void ScoreDelta::merge(const ScoreDelta& next)
+	{
+		mergeMap(notes, next.notes);
+		mergeMap(holdNotes, next.holdNotes);
+		mergeMap(hiSpeedChanges, next.hiSpeedChanges);
+		mergeMap(timeSignatures, next.timeSignatures);
+		mergeValue(tempoChanges, next.tempoChanges);
+		mergeValue(skills, next.skills);
+		mergeValue(fever, next.fever);
+		mergeValue(metadata, next.metadata);
+		mergeValue(layers, next.layers);
+		mergeValue(waypoints, next.waypoints);
+	}
+
+	void ScoreDelta::applyForward(Score& score) const { applyDelta(*this, score, true); }
+
+	void ScoreDelta::applyBackward(Score& score) const { applyDelta(*this, score, false); }
+
+	bool ScoreDelta::empty() const
+	{
+		return notes.empty() && holdNotes.empty() && hiSpeedChanges.empty() &&
+		       timeSignatures.empty() && !tempoChanges.changed && !skills.changed &&
+		       !fever.changed && !metadata.changed && !layers.changed && !waypoints.changed;
+	}
+
+	size_t ScoreDelta::getByteSize() const
+	{
+		return byteSize(notes) + byteSize(holdNotes) + byteSize(hiSpeedChanges) +
+		       byteSize(timeSignatures) + byteSize(tempoChanges) + byteSize(skills) +
+		       byteSize(fever) + byteSize(metadata) + byteSize(layers) + byteSize(waypoints);
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Score.h"
+#include <vector>
+
+namespace MikuMikuWorld
+{
+	// Keyed changes of a map-like container, where each entry stores the element before and after
+	template <typename Key, typename Value>
+	struct MapDelta
+	{
+		struct Entry
+		{
+			Key key;
+			bool existedBefore;
+			bool existsAfter;
+			Value before;
+			Value after;
+		};
+
+		std::vector<Entry> entries;
+
+		inline bool empty() const { return entries.empty(); }
+	};
+
+	// Whole-value change of a small member, only meaningful when `changed` is set
+	template <typename T>
+	struct ValueDelta
+	{
+		bool changed{ false };
+		T before{};
+		T after{};
+	};
+
+	/**
+	 * @brief Difference between two versions of a score that can be applied in both directions
+	 * @note Notes, holds, hi-speed changes and time signatures are stored per changed element, so
+	 *       the size of a delta is proportional to the size of the edit rather than the score.
+	 *       The remaining members are small and are stored as a whole when they change
+	 */
+	class ScoreDelta
+	{
+	  public:
+		MapDelta<int, Note> notes;
+		MapDelta<int, HoldNote> holdNotes;
+		MapDelta<int, HiSpeedChange> hiSpeedChanges;
+		MapDelta<int, TimeSignature> timeSignatures;
+		ValueDelta<std::vector<Tempo>> tempoChanges;
+		ValueDelta<std::vector<SkillTrigger>> skills;
+		ValueDelta<Fever> fever;
+		ValueDelta<ScoreMetadata> metadata;
+		ValueDelta<std::vector<Layer>> layers;
+		ValueDelta<std::vector<Waypoint>> waypoints;
+
+		static ScoreDelta between(const Score& prev, const Score& curr);
+
+		/**
+		 * @brief Appends a later delta so that this delta covers both edits
+		 * @param next A delta computed from the score this delta produces
+		 */
+		void merge(const ScoreDelta& next);
+
+		// Turns the previous version of the score into the current one
+		void applyForward(Score& score) const;
+		// Turns the current version of the score back into the previous one
+		void applyBackward(Score& score) const;
+
+		bool empty() const;
+		// Approximate heap and inline memory used by this delta in bytes
+		size_t getByteSize() const;
+	};
+}
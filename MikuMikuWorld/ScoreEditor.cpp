@@ -7,8 +7,10 @@
 #include "ApplicationConfiguration.h"
 #include "Constants.h"
 #include "File.h"
+#include "FileDialog.h"
 #include "SUS.h"
 #include "ScoreConverter.h"
+#include "ScoreJournal.h"
 #include "SusExporter.h"
 #include "SusParser.h"
 #include "UI.h"
@@ -271,6 +273,7 @@ namespace MikuMikuWorld
 			propertiesWindow.isPendingLoadMusic = false;
 		}
 
+		checkAutoSave();
 		if (config.autoSaveEnabled && autoSaveTimer.elapsedMinutes() >= config.autoSaveInterval)
 		{
 			autoSave();
@@ -292,11 +295,12 @@ namespace MikuMikuWorld
 		             ImGuiWindowFlags_Static | ImGuiWindowFlags_NoScrollbar |
 		                 ImGuiWindowFlags_NoScrollWithMouse);
 		timeline.update(context, edit, renderer.get());
+		renderer->endFrame();
 		ImGui::End();
 
 		if (config.debugEnabled)
 		{
-			debugWindow.update(context, timeline);
+			debugWindow.update(context, timeline, *renderer);
 		}
 
 		if (ImGui::Begin(IMGUI_TITLE(ICON_FA_ALIGN_LEFT, "chart_properties"), NULL,
@@ -364,6 +368,11 @@ namespace MikuMikuWorld
 		timeline.setPlaying(context, false);
 
 		context.score = {};
+		context.invalidateIndices();
+		context.noteColumns.invalidate();
+		context.holdCurves.invalidate();
+		context.tempoMap.invalidate();
+		context.measureTable.invalidate();
 		context.workingData = {};
 		context.history.clear();
 		context.scoreStats.reset();
@@ -371,6 +380,7 @@ namespace MikuMikuWorld
 		context.waveformL.clear();
 		context.waveformR.clear();
 		context.clearSelection();
+		journalBaseFilename.clear();
 
 		// New score; nothing to save
 		context.upToDate = true;
@@ -393,6 +403,7 @@ namespace MikuMikuWorld
 			resetNextID();
 			std::string workingFilename;
 			Score newScore;
+			int journalRecords = 0;
 
 			if (extension == SUS_EXTENSION)
 			{
@@ -412,6 +423,7 @@ namespace MikuMikuWorld
 			else if (extension == MMWS_EXTENSION || extension == CC_MMWS_EXTENSION)
 			{
 				newScore = deserializeScore(filename);
+				journalRecords = replayScoreJournal(newScore, filename);
 				workingFilename = filename;
 			}
 			else if (extension == JSON_EXTENSION) {
@@ -420,19 +432,27 @@ namespace MikuMikuWorld
 
 			context.clearSelection();
 			context.history.clear();
+			journalBaseFilename.clear();
 			context.score = std::move(newScore);
+			context.invalidateIndices();
+			context.noteColumns.invalidate();
+			context.holdCurves.invalidate();
+			context.tempoMap.invalidate();
+			context.measureTable.invalidate();
 			context.workingData = EditorScoreData(context.score.metadata, workingFilename);
 
 			loadMusic(context.workingData.musicFilename);
 			context.audio.setMusicOffset(0, context.workingData.musicOffset);
 
-			context.scoreStats.calculateStats(context.score);
+			context.updateStats();
 			timeline.calculateMaxOffsetFromScore(context.score);
 
+			// Changes restored from a journal are not in the loaded file yet
+			context.upToDate = journalRecords == 0;
 			UI::setWindowTitle((context.workingData.filename.size()
 			                        ? IO::File::getFilename(context.workingData.filename)
-			                        : windowUntitled));
-			context.upToDate = true;
+			                        : windowUntitled) +
+			                   (context.upToDate ? "" : "*"));
 		}
 		catch (std::exception& error)
 		{
@@ -498,7 +518,20 @@ namespace MikuMikuWorld
 			int laneExtension = context.score.metadata.laneExtension;
 			context.score.metadata = context.workingData.toScoreMetadata();
 			context.score.metadata.laneExtension = laneExtension;
-			serializeScore(context.score, filename);
+			// Saving over the base of the running journal ends it, the next auto save starts over
+			if (filename == journalBaseFilename)
+			{
+				if (autoSaveTask.valid())
+					autoSaveTask.wait();
+
+				journalBaseFilename.clear();
+			}
+
+			serializeScore(context.score, filename, config.compactScoreFiles);
+
+			// A journal left next to the file no longer applies to it
+			std::error_code error;
+			std::filesystem::remove(IO::mbToWideStr(getScoreJournalFilename(filename)), error);
 
 			UI::setWindowTitle(IO::File::getFilename(filename));
 			context.upToDate = true;
@@ -820,11 +853,33 @@ namespace MikuMikuWorld
 			ImGui::EndMenu();
 		}
 
+		std::string fps;
+		float fpsWidth = 0;
 		if (config.showFPS)
 		{
-			std::string fps = IO::formatString("%.3fms (%.1fFPS)", ImGui::GetIO().DeltaTime * 1000,
-			                                   ImGui::GetIO().Framerate);
-			ImGui::SetCursorPosX(ImGui::GetWindowSize().x - ImGui::CalcTextSize(fps.c_str()).x -
+			fps = IO::formatString("%.3fms (%.1fFPS)", ImGui::GetIO().DeltaTime * 1000,
+			                       ImGui::GetIO().Framerate);
+			fpsWidth = ImGui::CalcTextSize(fps.c_str()).x;
+		}
+
+		// The auto save status sits to the left of the frame time
+		if (!autoSaveStatus.empty())
+		{
+			float statusWidth = ImGui::CalcTextSize(autoSaveStatus.c_str()).x;
+			if (config.showFPS)
+				statusWidth += ImGui::GetStyle().ItemSpacing.x * 2;
+
+			ImGui::SetCursorPosX(ImGui::GetWindowSize().x - fpsWidth - statusWidth -
+			                     ImGui::GetStyle().WindowPadding.x);
+			if (autoSaveFailed)
+				ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", autoSaveStatus.c_str());
+			else
+				ImGui::TextDisabled("%s", autoSaveStatus.c_str());
+		}
+
+		if (config.showFPS)
+		{
+			ImGui::SetCursorPosX(ImGui::GetWindowSize().x - fpsWidth -
 			                     ImGui::GetStyle().WindowPadding.x);
 			ImGui::Text(fps.c_str());
 		}
@@ -937,30 +992,117 @@ namespace MikuMikuWorld
 
 	void ScoreEditor::autoSave()
 	{
-		std::wstring wAutoSaveDir = IO::mbToWideStr(autoSavePath);
+		checkAutoSave();
 
-		// create auto save directory if none exists
-		if (!std::filesystem::exists(wAutoSaveDir))
-			std::filesystem::create_directory(wAutoSaveDir);
+		// Skip this interval instead of waiting for a save that is still running
+		if (autoSaveTask.valid())
+		{
+			autoSaveStatus = IO::formatString("%s (%s)", getString("auto_save_skipped"),
+			                                  Utilities::getCurrentTime().c_str());
+			autoSaveFailed = false;
+			return;
+		}
 
 		int laneExtension = context.score.metadata.laneExtension;
 		context.score.metadata = context.workingData.toScoreMetadata();
 		context.score.metadata.laneExtension = laneExtension;
-		serializeScore(context.score, autoSavePath + "\\mmw_auto_save_" +
-		                                  Utilities::getCurrentDateTime() + CC_MMWS_EXTENSION);
 
-		// get mmws files
-		int mmwsCount = 0;
-		for (const auto& file : std::filesystem::directory_iterator(wAutoSaveDir))
+		// The copy shares the score's containers, edits made while saving detach from it
+		Score snapshot = context.score;
+
+		// Append only the changes since the previous auto save until enough of them were appended,
+		// then write a new full auto save for the journal to start from
+		if (config.autoSaveJournal && !journalBaseFilename.empty() &&
+		    journalRecordCount < config.autoSaveJournalCompactCount)
 		{
-			std::string extension = file.path().extension().string();
-			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-			mmwsCount += extension == CC_MMWS_EXTENSION;
+			Score prev = std::move(journalScore);
+			journalScore = snapshot;
+
+			autoSaveTask = std::async(std::launch::async,
+			                          [prev = std::move(prev), snapshot = std::move(snapshot),
+			                           baseFilename = journalBaseFilename]
+			                          {
+				                          ScoreDelta delta = ScoreDelta::between(prev, snapshot);
+				                          if (delta.empty())
+					                          return false;
+
+				                          appendScoreJournal(delta, baseFilename);
+				                          return true;
+			                          });
+			return;
 		}
 
-		// delete older files
-		if (mmwsCount > config.autoSaveMaxCount)
-			deleteOldAutoSave(mmwsCount - config.autoSaveMaxCount);
+		std::string filename = autoSavePath + "\\mmw_auto_save_" +
+		                       Utilities::getCurrentDateTime() + CC_MMWS_EXTENSION;
+		int maxCount = config.autoSaveMaxCount;
+		bool createJournal = config.autoSaveJournal;
+
+		journalBaseFilename = createJournal ? filename : "";
+		journalRecordCount = 0;
+		if (createJournal)
+			journalScore = snapshot;
+
+		autoSaveTask = std::async(
+		    std::launch::async,
+		    [this, snapshot = std::move(snapshot), filename, maxCount, createJournal]
+		    {
+			    std::wstring wAutoSaveDir = IO::mbToWideStr(autoSavePath);
+
+			    // create auto save directory if none exists
+			    if (!std::filesystem::exists(wAutoSaveDir))
+				    std::filesystem::create_directory(wAutoSaveDir);
+
+			    serializeScore(snapshot, filename);
+			    if (createJournal)
+				    createScoreJournal(snapshot, filename);
+
+			    // get mmws files
+			    int mmwsCount = 0;
+			    for (const auto& file : std::filesystem::directory_iterator(wAutoSaveDir))
+			    {
+				    std::string extension = file.path().extension().string();
+				    std::transform(extension.begin(), extension.end(), extension.begin(),
+				                   ::tolower);
+				    mmwsCount += extension == CC_MMWS_EXTENSION;
+			    }
+
+			    // delete older files
+			    if (mmwsCount > maxCount)
+				    deleteOldAutoSave(mmwsCount - maxCount);
+
+			    return false;
+		    });
+	}
+
+	void ScoreEditor::checkAutoSave()
+	{
+		if (!autoSaveTask.valid() ||
+		    autoSaveTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+
+		try
+		{
+			// Intervals without changes append nothing and do not count toward compaction
+			if (autoSaveTask.get())
+				++journalRecordCount;
+
+			autoSaveStatus = IO::formatString("%s %s", getString("auto_save_last"),
+			                                  Utilities::getCurrentTime().c_str());
+			autoSaveFailed = false;
+		}
+		catch (const std::exception& e)
+		{
+			// The journal may be missing changes, start over from a full auto save
+			journalBaseFilename.clear();
+
+			// Only the first of consecutive failures opens a message box
+			const bool firstFailure = !autoSaveFailed;
+			autoSaveStatus = IO::formatString("%s: %s", getString("auto_save_failed"), e.what());
+			autoSaveFailed = true;
+			if (firstFailure)
+				IO::messageBox(APP_NAME, autoSaveStatus, IO::MessageBoxButtons::Ok,
+				               IO::MessageBoxIcon::Error);
+		}
 	}
 
 	int ScoreEditor::deleteOldAutoSave(int count)
@@ -976,7 +1118,7 @@ namespace MikuMikuWorld
 		{
 			std::string extension = file.path().extension().string();
 			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-			if (extension == MMWS_EXTENSION)
+			if (extension == CC_MMWS_EXTENSION)
 				deleteFiles.push_back(file);
 		}
 
@@ -989,7 +1131,11 @@ namespace MikuMikuWorld
 		int remainingCount = count;
 		while (remainingCount && deleteFiles.size())
 		{
-			std::filesystem::remove(deleteFiles.begin()->path());
+			std::filesystem::path path = deleteFiles.begin()->path();
+			std::filesystem::remove(path);
+
+			std::error_code error;
+			std::filesystem::remove(path.replace_extension(MMWS_JOURNAL_EXTENSION), error);
 			deleteFiles.erase(deleteFiles.begin());
 
 			--remainingCount;
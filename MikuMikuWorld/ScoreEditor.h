@@ -26,6 +26,16 @@ namespace MikuMikuWorld
 
 		Stopwatch autoSaveTimer;
 		std::string autoSavePath;
+		// Returns whether a record was appended to the journal. Declared after the members the
+		// worker uses so it is joined before they are destroyed
+		std::future<bool> autoSaveTask;
+		// Journal auto save: the latest full auto save and the score last written to its journal
+		std::string journalBaseFilename;
+		Score journalScore;
+		int journalRecordCount{};
+		// Outcome of the latest auto save interval, shown in the menu bar
+		std::string autoSaveStatus;
+		bool autoSaveFailed{};
 		bool showImGuiDemoWindow;
 
 		bool save(std::string filename);
@@ -47,6 +57,8 @@ namespace MikuMikuWorld
 		bool saveAs();
 		bool trySave(std::string);
 		void autoSave();
+		// Reports the result of the last auto save once its worker has finished
+		void checkAutoSave();
 		int deleteOldAutoSave(int count);
 
 		void drawMenubar();
@@ -346,7 +346,7 @@ namespace MikuMikuWorld
 			int selectedStartNum = 0;
 			for (const auto& noteId : context.selectedNotes)
 			{
-				auto noteType = context.score.notes.at(noteId).getType();
+				auto noteType = context.score.notes.get().at(noteId).getType();
 				if (noteType == NoteType::HoldMid)
 					selectedMidNum += 1;
 				if (noteType == NoteType::Hold)
@@ -478,8 +478,12 @@ namespace MikuMikuWorld
 			}
 
 			float yThreshold = (notesHeight * 0.5f) + 2.0f;
-			for (const auto& [id, note] : context.score.notes)
+			const int minSelectTick = positionToTick(-(bottom + yThreshold)) - 1;
+			const int maxSelectTick = positionToTick(-(top - yThreshold)) + 1;
+			for (int id :
+			     context.noteIndex.notesInRange(context.score, minSelectTick, maxSelectTick))
 			{
+				const Note& note = context.score.notes.get().at(id);
 				const bool layerHidden = context.score.layers.at(note.layer).hidden;
 				if ((layerHidden || note.layer != context.selectedLayer) && !context.showAllLayers)
 					continue;
@@ -496,7 +500,7 @@ namespace MikuMikuWorld
 						context.selectedNotes.insert(id);
 				}
 			}
-			for (const auto& [id, hsc] : context.score.hiSpeedChanges)
+			for (const auto& [id, hsc] : context.score.hiSpeedChanges.get())
 			{
 				float lx =
 				    laneToPosition(MAX_LANE + context.score.metadata.laneExtension + 1) + 123;
@@ -553,13 +557,15 @@ namespace MikuMikuWorld
 		// Draw measures
 		int firstTick = std::max(0, positionToTick(visualOffset - size.y));
 		int lastTick = positionToTick(visualOffset);
-		int measure = accumulateMeasures(firstTick, TICKS_PER_BEAT, context.score.timeSignatures);
-		firstTick = measureToTicks(measure, TICKS_PER_BEAT, context.score.timeSignatures);
-
-		int tsIndex = findTimeSignature(measure, context.score.timeSignatures);
-		int ticksPerMeasure =
-		    beatsPerMeasure(context.score.timeSignatures[tsIndex]) * TICKS_PER_BEAT;
-		int beatTicks = ticksPerMeasure / context.score.timeSignatures[tsIndex].numerator;
+		const auto& timeSignatures = context.score.timeSignatures;
+		int measure = context.measureTable.ticksToMeasure(firstTick, timeSignatures);
+		firstTick = context.measureTable.measureToTicks(measure, timeSignatures);
+
+		const MeasureTable::Segment* measureSegment =
+		    &context.measureTable.segmentAtMeasure(measure, timeSignatures);
+		int tsIndex = measureSegment->measure;
+		int ticksPerMeasure = measureSegment->ticksPerMeasure;
+		int beatTicks = measureSegment->beatTicks;
 		int subdivision = TICKS_PER_BEAT / (division / 4);
 
 		// Snap to the sub-division before the current measure to prevent the lines from jumping
@@ -568,27 +574,23 @@ namespace MikuMikuWorld
 		     tick += subdivision)
 		{
 			const int y = position.y - tickToPosition(tick) + visualOffset;
-			int currentMeasure =
-			    accumulateMeasures(tick, TICKS_PER_BEAT, context.score.timeSignatures);
+			int currentMeasure = context.measureTable.ticksToMeasure(tick, timeSignatures);
+			measureSegment = &context.measureTable.segmentAtMeasure(currentMeasure, timeSignatures);
 
 			// Time signature changes on current measure
-			if (context.score.timeSignatures.find(currentMeasure) !=
-			        context.score.timeSignatures.end() &&
-			    currentMeasure != tsIndex)
+			if (measureSegment->measure == currentMeasure && currentMeasure != tsIndex)
 			{
 				tsIndex = currentMeasure;
-				ticksPerMeasure =
-				    beatsPerMeasure(context.score.timeSignatures[tsIndex]) * TICKS_PER_BEAT;
-				beatTicks = ticksPerMeasure / context.score.timeSignatures[tsIndex].numerator;
+				ticksPerMeasure = measureSegment->ticksPerMeasure;
+				beatTicks = measureSegment->beatTicks;
 
 				// snap to sub-division again on time signature change
-				tick = measureToTicks(currentMeasure, TICKS_PER_BEAT, context.score.timeSignatures);
+				tick = measureSegment->tick;
 				tick -= tick % subdivision;
 			}
 
 			// determine whether the tick is a beat relative to its measure's tick
-			int measureTicks =
-			    measureToTicks(currentMeasure, TICKS_PER_BEAT, context.score.timeSignatures);
+			int measureTicks = context.measureTable.measureToTicks(currentMeasure, timeSignatures);
 
 			ImU32 color;
 			ImU32 exColor;
@@ -615,18 +617,15 @@ namespace MikuMikuWorld
 			drawList->AddLine(ImVec2(x2, y), ImVec2(exX2, y), exColor, thickness);
 		}
 
-		tsIndex = findTimeSignature(measure, context.score.timeSignatures);
-		ticksPerMeasure = beatsPerMeasure(context.score.timeSignatures[tsIndex]) * TICKS_PER_BEAT;
+		ticksPerMeasure =
+		    context.measureTable.segmentAtMeasure(measure, timeSignatures).ticksPerMeasure;
 
 		// Overdraw one measure to make sure the measure string is always visible
 		for (int tick = firstTick; tick < lastTick + ticksPerMeasure; tick += ticksPerMeasure)
 		{
-			if (context.score.timeSignatures.find(measure) != context.score.timeSignatures.end())
-			{
-				tsIndex = measure;
-				ticksPerMeasure =
-				    beatsPerMeasure(context.score.timeSignatures[tsIndex]) * TICKS_PER_BEAT;
-			}
+			measureSegment = &context.measureTable.segmentAtMeasure(measure, timeSignatures);
+			if (measureSegment->measure == measure)
+				ticksPerMeasure = measureSegment->ticksPerMeasure;
 
 			std::string measureStr = std::to_string(measure);
 			const float txtPos =
@@ -672,7 +671,7 @@ namespace MikuMikuWorld
 		contextMenu(context);
 
 		// Update hi-speed changes
-		for (auto& [id, hiSpeed] : context.score.hiSpeedChanges)
+		for (const auto& [id, hiSpeed] : context.score.hiSpeedChanges.get())
 		{
 			if (hiSpeedControl(context, hiSpeed))
 			{
@@ -688,7 +687,7 @@ namespace MikuMikuWorld
 		{
 			if (timeSignatureControl(
 			        context.score, ts.numerator, ts.denominator,
-			        measureToTicks(ts.measure, TICKS_PER_BEAT, context.score.timeSignatures),
+			        context.measureTable.measureToTicks(ts.measure, context.score.timeSignatures),
 			        !playing))
 			{
 				eventEdit.editIndex = measure;
@@ -702,7 +701,7 @@ namespace MikuMikuWorld
 		// Update bpm changes
 		for (int index = 0; index < context.score.tempoChanges.size(); ++index)
 		{
-			Tempo& tempo = context.score.tempoChanges[index];
+			const Tempo& tempo = context.score.tempoChanges.get()[index];
 			if (bpmControl(context.score, tempo))
 			{
 				eventEdit.editIndex = index;
@@ -728,10 +727,10 @@ namespace MikuMikuWorld
 		// Update song boundaries
 		if (context.audio.isMusicInitialized())
 		{
-			int startTick = accumulateTicks(context.workingData.musicOffset / 1000, TICKS_PER_BEAT,
-			                                context.score.tempoChanges);
-			int endTick = accumulateTicks(context.audio.getMusicEndTime(), TICKS_PER_BEAT,
-			                              context.score.tempoChanges);
+			int startTick = context.tempoMap.secondsToTicks(context.workingData.musicOffset / 1000,
+			                                                context.score.tempoChanges);
+			int endTick = context.tempoMap.secondsToTicks(context.audio.getMusicEndTime(),
+			                                              context.score.tempoChanges);
 
 			float x = getTimelineEndX(context.score);
 			float y1 = position.y - tickToPosition(startTick) + visualOffset;
@@ -763,7 +762,7 @@ namespace MikuMikuWorld
 		// Selection boxes
 		for (int id : context.selectedNotes)
 		{
-			const Note& note = context.score.notes.at(id);
+			const Note& note = context.score.notes.get().at(id);
 			if (!isNoteVisible(note, 0))
 				continue;
 
@@ -858,7 +857,8 @@ namespace MikuMikuWorld
 		{
 			gotoMeasure = std::max(gotoMeasure, 0);
 			scrollTimeline(
-			    context, measureToTicks(gotoMeasure, TICKS_PER_BEAT, context.score.timeSignatures));
+			    context,
+			    context.measureTable.measureToTicks(gotoMeasure, context.score.timeSignatures));
 		}
 
 		ImGui::SameLine();
@@ -883,14 +883,14 @@ namespace MikuMikuWorld
 		ImGui::SameLine();
 
 		int currentMeasure =
-		    accumulateMeasures(context.currentTick, TICKS_PER_BEAT, context.score.timeSignatures);
-		const TimeSignature& ts =
-		    context.score
-		        .timeSignatures[findTimeSignature(currentMeasure, context.score.timeSignatures)];
-		const Tempo& tempo = getTempoAt(context.currentTick, context.score.tempoChanges);
-		int hiSpeed = findHighSpeedChange(context.currentTick, context.score.hiSpeedChanges,
-		                                  context.selectedLayer);
-		float speed = (hiSpeed == -1 ? 1.0f : context.score.hiSpeedChanges[hiSpeed].speed);
+		    context.measureTable.ticksToMeasure(context.currentTick, context.score.timeSignatures);
+		const MeasureTable::Segment& currentSegment =
+		    context.measureTable.segmentAtMeasure(currentMeasure, context.score.timeSignatures);
+		const TimeSignature& ts = context.score.timeSignatures[currentSegment.measure];
+		const Tempo& tempo =
+		    context.tempoMap.getTempoAt(context.currentTick, context.score.tempoChanges);
+		float speed = context.hiSpeedTimeline.speedAt(context.currentTick, context.selectedLayer,
+		                                              context.score.hiSpeedChanges);
 
 		std::string rhythmString = IO::formatString(
 		    "  %02d:%02d:%02d  |  %d/%d  |  %g BPM  |  %gx", (int)time / 60, (int)time % 60,
@@ -915,7 +915,8 @@ namespace MikuMikuWorld
 		if (playing)
 		{
 			time += ImGui::GetIO().DeltaTime * playbackSpeed;
-			context.currentTick = accumulateTicks(time, TICKS_PER_BEAT, context.score.tempoChanges);
+			context.currentTick =
+			    context.tempoMap.secondsToTicks(time, context.score.tempoChanges);
 
 			float cursorY = tickToPosition(context.currentTick);
 			if (config.followCursorInPlayback)
@@ -931,8 +932,7 @@ namespace MikuMikuWorld
 		}
 		else
 		{
-			time =
-			    accumulateDuration(context.currentTick, TICKS_PER_BEAT, context.score.tempoChanges);
+			time = context.tempoMap.ticksToSeconds(context.currentTick, context.score.tempoChanges);
 		}
 	}
 
@@ -953,58 +953,78 @@ namespace MikuMikuWorld
 		renderer->beginBatch();
 
 		minNoteYDistance = INT_MAX;
-		for (auto& [id, note] : context.score.notes)
+
+		// Only notes within the visible tick window can pass isNoteVisible
+		const int minVisibleTick = positionToTick(visualOffset - size.y - position.y) - 1;
+		const int maxVisibleTick = positionToTick(visualOffset + 100) + 1;
+		for (int id :
+		     context.noteIndex.notesInRange(context.score, minVisibleTick, maxVisibleTick))
 		{
+			// Read through const access so frames without edits never detach the score
+			const auto& notes = context.score.notes.get();
+			auto it = notes.find(id);
+			if (it == notes.end())
+				continue;
+
+			const Note& note = it->second;
 			const bool layerHidden = context.score.layers.at(note.layer).hidden;
 			if (!isNoteVisible(note) || (layerHidden && !context.showAllLayers))
 				continue;
 
-			if (note.getType() == NoteType::Tap)
-			{
-				updateNote(context, edit, note);
-				drawNote(note, renderer,
-				         (context.showAllLayers || note.layer == context.selectedLayer)
-				             ? noteTint
-				             : otherLayerTint,
-				         0, 0, context.showAllLayers || note.layer == context.selectedLayer);
-			}
-			if (note.getType() == NoteType::Damage)
-			{
-				updateNote(context, edit, note);
-				drawCcNote(note, renderer,
-				           (context.showAllLayers || note.layer == context.selectedLayer)
-				               ? noteTint
-				               : otherLayerTint,
-				           0, 0, context.showAllLayers || note.layer == context.selectedLayer);
-			}
+			const NoteType type = note.getType();
+			if (type != NoteType::Tap && type != NoteType::Damage)
+				continue;
+
+			// Edits made by updateNote may have moved the note to a detached copy of the notes
+			updateNote(context, edit, id);
+			const Note& updated = context.score.notes.get().at(id);
+			const bool inSelectedLayer =
+			    context.showAllLayers || updated.layer == context.selectedLayer;
+			if (type == NoteType::Tap)
+				drawNote(updated, renderer, inSelectedLayer ? noteTint : otherLayerTint, 0, 0,
+				         inSelectedLayer);
+			else
+				drawCcNote(updated, renderer, inSelectedLayer ? noteTint : otherLayerTint, 0, 0,
+				           inSelectedLayer);
 		}
 
-		for (auto& [id, hold] : context.score.holdNotes)
+		for (int id :
+		     context.holdIndex.holdsInRange(context.score, minVisibleTick, maxVisibleTick))
 		{
-			Note& start = context.score.notes.at(hold.start.ID);
-			Note& end = context.score.notes.at(hold.end);
+			const auto& holds = context.score.holdNotes.get();
+			auto it = holds.find(id);
+			if (it == holds.end())
+				continue;
+
+			const int endID = it->second.end;
+			const Note& start = context.score.notes.get().at(id);
+			const Note& end = context.score.notes.get().at(endID);
 
 			const bool startLayerHidden = context.score.layers.at(start.layer).hidden;
 			const bool endLayerHidden = context.score.layers.at(end.layer).hidden;
 			if ((startLayerHidden || endLayerHidden) && !context.showAllLayers)
 				continue;
 
+			const bool endVisible = isNoteVisible(end);
 			if (isNoteVisible(start))
-				updateNote(context, edit, start);
-			if (isNoteVisible(end))
-				updateNote(context, edit, end);
+				updateNote(context, edit, id);
+			if (endVisible)
+				updateNote(context, edit, endID);
 
-			for (const auto& step : hold.steps)
+			// Releasing a note sorts the steps into a detached copy of the hold, look it up again
+			for (size_t i = 0; i < context.score.holdNotes.get().at(id).steps.size(); ++i)
 			{
-				Note& mid = context.score.notes.at(step.ID);
-				if (isNoteVisible(mid))
-					updateNote(context, edit, mid);
+				const int stepID = context.score.holdNotes.get().at(id).steps[i].ID;
+				if (isNoteVisible(context.score.notes.get().at(stepID)))
+					updateNote(context, edit, stepID);
 				if (skipUpdateAfterSortingSteps)
 					break;
 			}
 
+			const HoldNote& hold = context.score.holdNotes.get().at(id);
 			drawHoldNote(context.score.notes, hold, renderer, noteTint,
-			             context.showAllLayers ? -1 : context.selectedLayer);
+			             context.showAllLayers ? -1 : context.selectedLayer, 0, 0,
+			             &context.holdCurves.getSegments(id));
 		}
 		skipUpdateAfterSortingSteps = false;
 
@@ -1130,7 +1150,7 @@ namespace MikuMikuWorld
 	{
 		if (currentMode == TimelineMode::InsertBPM)
 		{
-			for (const auto& tempo : context.score.tempoChanges)
+			for (const auto& tempo : context.score.tempoChanges.get())
 				if (tempo.tick == hoverTick)
 					return;
 
@@ -1138,23 +1158,25 @@ namespace MikuMikuWorld
 			context.score.tempoChanges.push_back({ hoverTick, edit.bpm });
 			std::sort(context.score.tempoChanges.begin(), context.score.tempoChanges.end(),
 			          [](const auto& a, const auto& b) { return a.tick < b.tick; });
+			context.tempoMap.invalidate();
 			context.pushHistory("Insert BPM change", prev, context.score);
 		}
 		else if (currentMode == TimelineMode::InsertTimeSign)
 		{
 			int measure =
-			    accumulateMeasures(hoverTick, TICKS_PER_BEAT, context.score.timeSignatures);
+			    context.measureTable.ticksToMeasure(hoverTick, context.score.timeSignatures);
 			if (context.score.timeSignatures.find(measure) != context.score.timeSignatures.end())
 				return;
 
 			Score prev = context.score;
 			context.score.timeSignatures[measure] = { measure, edit.timeSignatureNumerator,
 				                                      edit.timeSignatureDenominator };
+			context.measureTable.invalidate();
 			context.pushHistory("Insert time signature", prev, context.score);
 		}
 		else if (currentMode == TimelineMode::InsertHiSpeed)
 		{
-			for (const auto& [_, hs] : context.score.hiSpeedChanges)
+			for (const auto& [_, hs] : context.score.hiSpeedChanges.get())
 				if (hs.tick == hoverTick && hs.layer == context.selectedLayer)
 					return;
 
@@ -1319,13 +1341,16 @@ namespace MikuMikuWorld
 
 	int ScoreEditorTimeline::findClosestHold(ScoreContext& context, int lane, int tick)
 	{
+		// Read only, const access keeps the notes shared with any snapshot
+		const Score& score = context.score;
 		float xt = laneToPosition(lane);
 		float yt = getNoteYPosFromTick(tick);
 
-		for (const auto& [id, hold] : context.score.holdNotes)
+		for (int id : context.holdIndex.holdsInRange(score, tick, tick))
 		{
-			const Note& start = context.score.notes.at(hold.start.ID);
-			const Note& end = context.score.notes.at(hold.end);
+			const HoldNote& hold = score.holdNotes.at(id);
+			const Note& start = score.notes.at(hold.start.ID);
+			const Note& end = score.notes.at(hold.end);
 
 			// No need to search holds outside the cursor's reach
 			if (start.tick > tick || end.tick < tick)
@@ -1343,8 +1368,8 @@ namespace MikuMikuWorld
 			{
 				// Getting here means we found a non-skip step
 				if ((context.showAllLayers || start.layer == context.selectedLayer ||
-				     context.score.notes.at(hold.steps[s2].ID).layer == context.selectedLayer) &&
-				    isMouseInHoldPath(start, context.score.notes.at(hold.steps[s2].ID),
+				     score.notes.at(hold.steps[s2].ID).layer == context.selectedLayer) &&
+				    isMouseInHoldPath(start, score.notes.at(hold.steps[s2].ID),
 				                      hold.start.ease, xt, yt))
 					return id;
 
@@ -1353,8 +1378,8 @@ namespace MikuMikuWorld
 				{
 					if (hold.steps[s2].type != HoldStepType::Skip)
 					{
-						const Note& m1 = context.score.notes.at(hold.steps[s1].ID);
-						const Note& m2 = context.score.notes.at(hold.steps[s2].ID);
+						const Note& m1 = score.notes.at(hold.steps[s1].ID);
+						const Note& m2 = score.notes.at(hold.steps[s2].ID);
 						if ((context.showAllLayers || m1.layer == context.selectedLayer ||
 						     m2.layer == context.selectedLayer) &&
 						    isMouseInHoldPath(m1, m2, hold.steps[s1].ease, xt, yt))
@@ -1366,8 +1391,8 @@ namespace MikuMikuWorld
 
 				int nextId = hold.steps[s1].ID;
 				if ((context.showAllLayers || start.layer == context.selectedLayer ||
-				     context.score.notes.at(nextId).layer == context.selectedLayer) &&
-				    isMouseInHoldPath(context.score.notes.at(nextId), end, hold.steps[s1].ease, xt,
+				     score.notes.at(nextId).layer == context.selectedLayer) &&
+				    isMouseInHoldPath(score.notes.at(nextId), end, hold.steps[s1].ease, xt,
 				                      yt))
 					return id;
 			}
@@ -1408,6 +1433,8 @@ namespace MikuMikuWorld
 		// Note clicked
 		if (ImGui::IsItemActivated())
 		{
+			// Cheap snapshot sharing storage with the score, dragging edits notes through
+			// `context.score.notes.at()` which detaches the score instead of writing into it
 			prevUpdateScore = context.score;
 			ctrlMousePos = mousePos;
 			holdLane = hoverLane;
@@ -1426,8 +1453,8 @@ namespace MikuMikuWorld
 		if (ImGui::IsItemDeactivated())
 		{
 			bool noChange = false;
-			auto it = context.score.notes.find(holdingNote);
-			if (it != context.score.notes.end())
+			auto it = context.score.notes.get().find(holdingNote);
+			if (it != context.score.notes.get().end())
 				noChange = noteTransformOrigin.isSame(it->second);
 
 			isHoldingNote = false;
@@ -1487,20 +1514,23 @@ namespace MikuMikuWorld
 		return false;
 	}
 
-	void ScoreEditorTimeline::updateNote(ScoreContext& context, EditArgs& edit, Note& note)
+	void ScoreEditorTimeline::updateNote(ScoreContext& context, EditArgs& edit, int noteID)
 	{
-		if (!(context.showAllLayers || context.selectedLayer == note.layer))
+		// The first edit of a drag detaches the notes from the snapshot taken by noteControl,
+		// so the note is looked up again after every control instead of keeping a reference
+		const Note* note = &context.score.notes.get().at(noteID);
+		if (!(context.showAllLayers || context.selectedLayer == note->layer))
 			return;
 		const float minLane = MIN_LANE - context.score.metadata.laneExtension;
 		const float maxLane = MAX_LANE + context.score.metadata.laneExtension;
 		const float maxNoteWidth = MAX_NOTE_WIDTH + context.score.metadata.laneExtension * 2;
 
 		const float btnPosY =
-		    position.y - tickToPosition(note.tick) + visualOffset - (notesHeight * 0.5f);
-		float btnPosX = laneToPosition(note.lane) + position.x - 2.0f;
+		    position.y - tickToPosition(note->tick) + visualOffset - (notesHeight * 0.5f);
+		float btnPosX = laneToPosition(note->lane) + position.x - 2.0f;
 
 		ImVec2 pos{ btnPosX, btnPosY };
-		ImVec2 noteSz{ laneToPosition(note.lane + note.width) + position.x + 2.0f - btnPosX,
+		ImVec2 noteSz{ laneToPosition(note->lane + note->width) + position.x + 2.0f - btnPosX,
 			           notesHeight };
 		ImVec2 sz{ noteControlWidth, notesHeight };
 
@@ -1514,32 +1544,32 @@ namespace MikuMikuWorld
 			if (noteYDistance < minNoteYDistance || io.KeyCtrl)
 			{
 				minNoteYDistance = noteYDistance;
-				hoveringNote = note.ID;
+				hoveringNote = note->ID;
 				if (ImGui::IsMouseClicked(0) && !UI::isAnyPopupOpen())
 				{
-					if (!io.KeyCtrl && !io.KeyAlt && !context.isNoteSelected(note))
+					if (!io.KeyCtrl && !io.KeyAlt && !context.isNoteSelected(*note))
 					{
 						context.selectedNotes.clear();
 						context.selectedHiSpeedChanges.clear();
 					}
 
-					context.selectedNotes.insert(note.ID);
+					context.selectedNotes.insert(note->ID);
 
-					if (io.KeyAlt && context.isNoteSelected(note))
-						context.selectedNotes.erase(note.ID);
+					if (io.KeyAlt && context.isNoteSelected(*note))
+						context.selectedNotes.erase(note->ID);
 
-					if (context.isNoteSelected(note))
+					if (context.isNoteSelected(*note))
 					{
-						holdingNote = note.ID;
-						noteTransformOrigin = NoteTransform::fromNote(note);
+						holdingNote = note->ID;
+						noteTransformOrigin = NoteTransform::fromNote(*note);
 					}
 				}
 			}
 		}
 
 		// Left resize
-		ImGui::PushID(note.ID);
-		if (noteControl(context, note, pos, sz, "L", ImGuiMouseCursor_ResizeEW))
+		ImGui::PushID(note->ID);
+		if (noteControl(context, *note, pos, sz, "L", ImGuiMouseCursor_ResizeEW))
 		{
 			int curLane = positionToLane(mousePos.x);
 			int grabLane = std::clamp(positionToLane(ctrlMousePos.x), minLane, maxLane);
@@ -1551,7 +1581,7 @@ namespace MikuMikuWorld
 				    context.selectedNotes.begin(), context.selectedNotes.end(),
 				    [&context, diff, minLane, maxLane, maxNoteWidth](int id)
 				    {
-					    Note& n = context.score.notes.at(id);
+					    const Note& n = context.score.notes.get().at(id);
 					    int newLane = n.lane + diff;
 					    int newWidth = n.width - diff;
 					    return (newLane < minLane || newLane + newWidth - 1 > maxLane ||
@@ -1571,13 +1601,14 @@ namespace MikuMikuWorld
 			}
 		}
 
+		note = &context.score.notes.get().at(noteID);
 		pos.x += noteControlWidth;
 		// account for <1 width by always having this be positive
-		sz.x = std::max((laneWidth * note.width) + 4.0f - (noteControlWidth * 2.0f),
+		sz.x = std::max((laneWidth * note->width) + 4.0f - (noteControlWidth * 2.0f),
 		                (noteControlWidth * 2.0f));
 
 		// Move
-		if (noteControl(context, note, pos, sz, "M", ImGuiMouseCursor_Hand))
+		if (noteControl(context, *note, pos, sz, "M", ImGuiMouseCursor_Hand))
 		{
 			float curLane = truncf(positionToLane(mousePos.x));
 			float grabLane = truncf(std::clamp(positionToLane(ctrlMousePos.x), minLane, maxLane));
@@ -1592,7 +1623,7 @@ namespace MikuMikuWorld
 				    !std::any_of(context.selectedNotes.begin(), context.selectedNotes.end(),
 				                 [&context, laneDiff, minLane, maxLane](int id)
 				                 {
-					                 Note& n = context.score.notes.at(id);
+					                 const Note& n = context.score.notes.get().at(id);
 					                 int newLane = n.lane + laneDiff;
 					                 return (newLane < minLane || newLane + n.width - 1 > maxLane);
 				                 });
@@ -1616,7 +1647,7 @@ namespace MikuMikuWorld
 				bool canMove =
 				    !std::any_of(context.selectedNotes.begin(), context.selectedNotes.end(),
 				                 [&context, tickDiff](int id)
-				                 { return context.score.notes.at(id).tick + tickDiff < 0; });
+				                 { return context.score.notes.get().at(id).tick + tickDiff < 0; });
 
 				if (canMove)
 				{
@@ -1633,7 +1664,7 @@ namespace MikuMikuWorld
 					}
 					case SnapMode::Absolute:
 					{
-						int grabbingNoteTick = note.tick;
+						int grabbingNoteTick = context.score.notes.get().at(noteID).tick;
 						int grabbingNoteTickSnapped =
 						    roundTickDown(grabbingNoteTick + tickDiff, division);
 						int actualDiff = grabbingNoteTickSnapped - grabbingNoteTick;
@@ -1653,8 +1684,8 @@ namespace MikuMikuWorld
 						          sortedSelectedNotes.begin());
 						std::sort(sortedSelectedNotes.begin(), sortedSelectedNotes.end(),
 						          [&context](int a, int b) {
-							          return context.score.notes.at(a).tick <
-							                 context.score.notes.at(b).tick;
+							          return context.score.notes.get().at(a).tick <
+							                 context.score.notes.get().at(b).tick;
 						          });
 
 						for (int id : sortedSelectedNotes)
@@ -1669,6 +1700,8 @@ namespace MikuMikuWorld
 					default:
 						throw std::runtime_error("Invalid snap mode (Unreachable)");
 					}
+
+					context.updateIndices(context.selectedNotes);
 				}
 			}
 		}
@@ -1712,11 +1745,12 @@ namespace MikuMikuWorld
 			isMovingNote = false;
 		}
 
+		note = &context.score.notes.get().at(noteID);
 		pos.x += sz.x;
 		sz.x = noteControlWidth;
 
 		// Right resize
-		if (noteControl(context, note, pos, sz, "R", ImGuiMouseCursor_ResizeEW))
+		if (noteControl(context, *note, pos, sz, "R", ImGuiMouseCursor_ResizeEW))
 		{
 			int grabLane = std::clamp(positionToLane(ctrlMousePos.x), minLane, maxLane);
 			int curLane = positionToLane(mousePos.x);
@@ -1728,7 +1762,7 @@ namespace MikuMikuWorld
 				    context.selectedNotes.begin(), context.selectedNotes.end(),
 				    [&context, diff, maxLane](int id)
 				    {
-					    Note& n = context.score.notes.at(id);
+					    const Note& n = context.score.notes.get().at(id);
 					    int newWidth = n.width + diff;
 					    return (newWidth < MIN_NOTE_WIDTH || n.lane + newWidth - 1 > maxLane);
 				    });
@@ -1753,7 +1787,8 @@ namespace MikuMikuWorld
 	                                        bool isGuide, Renderer* renderer, const Color& tint_,
 	                                        const int offsetTick, const int offsetLane,
 	                                        const float startAlpha, const float endAlpha,
-	                                        const GuideColor guideColor, const int selectedLayer)
+	                                        const GuideColor guideColor, const int selectedLayer,
+	                                        HoldCurveSegment* curve)
 	{
 		int texIndex{ noteTextures.holdPath };
 		ZIndex zIndex{ ZIndex::HoldLine };
@@ -1774,70 +1809,108 @@ namespace MikuMikuWorld
 
 		const Sprite& spr = pathTex.sprites[sprIndex];
 
-		float startX1 = laneToPosition(n1.lane + offsetLane);
-		float startX2 = laneToPosition(n1.lane + n1.width + offsetLane);
-		float startY = getNoteYPosFromTick(n1.tick + offsetTick);
-
-		float endX1 = laneToPosition(n2.lane + offsetLane);
-		float endX2 = laneToPosition(n2.lane + n2.width + offsetLane);
-		float endY = getNoteYPosFromTick(n2.tick + offsetTick);
-
-		int left = spr.getX() + holdCutoffX;
-		int right = spr.getX() + spr.getWidth() - holdCutoffX;
-
-		auto easeFunc = getEaseFunction(ease);
-		float steps = std::max(5.0f, std::ceilf(abs((endY - startY)) / 10));
-		for (int y = 0; y < steps; ++y)
-		{
-			Color inactiveTint = tint * otherLayerTint;
-			const float percent1 = y / steps;
-			const float percent2 = (y + 1) / steps;
-
-			float xl1 = easeFunc(startX1, endX1, percent1) - 2;
-			float xr1 = easeFunc(startX2, endX2, percent1) + 2;
-			float y1 = lerp(startY, endY, percent1);
-			float y2 = lerp(startY, endY, percent2);
-			float xl2 = easeFunc(startX1, endX1, percent2) - 2;
-			float xr2 = easeFunc(startX2, endX2, percent2) + 2;
-
-			int z = (selectedLayer == -1 || ((y < steps / 2) ? n1 : n2).layer == selectedLayer)
-			            ? (int)ZIndex::zCount
-			            : 0;
-
-			if (y2 <= 0)
+		// y positions are measured from tick 0 so the quads only depend on the zoom
+		const float startY = tickToPosition(n1.tick + offsetTick);
+		const float endY = tickToPosition(n2.tick + offsetTick);
+		const int steps = static_cast<int>(std::max(5.0f, std::ceil(std::abs(endY - startY) / 10)));
+
+		const HoldCurveKey key{ n1.tick + offsetTick,
+			                    n2.tick + offsetTick,
+			                    n1.lane + (float)offsetLane,
+			                    n1.width,
+			                    n2.lane + (float)offsetLane,
+			                    n2.width,
+			                    n1.layer,
+			                    n2.layer,
+			                    ease,
+			                    steps,
+			                    unitHeight * zoom,
+			                    laneWidth,
+			                    laneOffset,
+			                    pathTex.getID(),
+			                    sprIndex,
+			                    selectedLayer,
+			                    { tint.r, tint.g, tint.b, tint.a },
+			                    startAlpha,
+			                    endAlpha };
+
+		if (!curve)
+			curve = &uncachedCurve;
+
+		if (!curve->matches(key))
+		{
+			curve->key = key;
+			curve->valid = true;
+			curve->quads.clear();
+			curve->quads.reserve(steps * HoldCurveSegment::quadsPerStep);
+
+			const int left = spr.getX() + holdCutoffX;
+			const int right = spr.getX() + spr.getWidth() - holdCutoffX;
+			const float top = spr.getY();
+			const float bottom = spr.getY() + spr.getHeight();
+			const Color inactiveTint = tint * otherLayerTint;
+			const float startRight = key.startLane + key.startWidth;
+			const float endRight = key.endLane + key.endWidth;
+			auto easeFunc = getEaseFunction(ease);
+			for (int y = 0; y < steps; ++y)
+			{
+				const float percent1 = y / (float)steps;
+				const float percent2 = (y + 1) / (float)steps;
+
+				float xl1 = laneToPosition(easeFunc(key.startLane, key.endLane, percent1)) - 2;
+				float xr1 = laneToPosition(easeFunc(startRight, endRight, percent1)) + 2;
+				float y1 = lerp(startY, endY, percent1);
+				float y2 = lerp(startY, endY, percent2);
+				float xl2 = laneToPosition(easeFunc(key.startLane, key.endLane, percent2)) - 2;
+				float xr2 = laneToPosition(easeFunc(startRight, endRight, percent2)) + 2;
+
+				Color localTint = noteTint;
+				if (selectedLayer != -1)
+					localTint = Color::lerp(n1.layer == selectedLayer ? noteTint : inactiveTint,
+					                        n2.layer == selectedLayer ? noteTint : inactiveTint,
+					                        percent1);
+
+				localTint.a = tint.a * lerp(0.7, 1, lerp(startAlpha, endAlpha, percent1));
+
+				Vector2 p1{ xl1, y1 };
+				Vector2 p2{ xl1 + holdSliceSize, y1 };
+				Vector2 p3{ xl2, y2 };
+				Vector2 p4{ xl2 + holdSliceSize, y2 };
+				curve->quads.push_back(renderer->createQuad(
+				    p1, p2, p3, p4, pathTex, left, left + holdSliceWidth, top, bottom, localTint));
+				p1.x = xl1 + holdSliceSize;
+				p2.x = xr1 - holdSliceSize;
+				p3.x = xl2 + holdSliceSize;
+				p4.x = xr2 - holdSliceSize;
+				curve->quads.push_back(renderer->createQuad(p1, p2, p3, p4, pathTex,
+				                                            left + holdSliceWidth,
+				                                            right - holdSliceWidth, top, bottom,
+				                                            localTint));
+				p1.x = xr1 - holdSliceSize;
+				p2.x = xr1;
+				p3.x = xr2 - holdSliceSize;
+				p4.x = xr2;
+				curve->quads.push_back(renderer->createQuad(p1, p2, p3, p4, pathTex,
+				                                            right - holdSliceWidth, right, top,
+				                                            bottom, localTint));
+			}
+		}
+
+		// Scrolling only moves the cached quads
+		const float offsetY = getNoteYPosFromTick(0);
+		const float visibleEnd = size.y + size.y + position.y + 100;
+		for (size_t i = 0; i < curve->quads.size(); i += HoldCurveSegment::quadsPerStep)
+		{
+			// The first vertex of a step's quads lies on the step's end, the second on its start
+			const Quad& q = curve->quads[i];
+			if (q.vertices[0].y + offsetY <= 0)
 				continue;
 
 			// rest of hold no longer visible
-			if (y1 > size.y + size.y + position.y + 100)
+			if (q.vertices[1].y + offsetY > visibleEnd)
 				break;
 
-			Color localTint =
-			    selectedLayer == -1
-			        ? noteTint
-			        : Color::lerp(n1.layer == selectedLayer ? noteTint : inactiveTint,
-			                      n2.layer == selectedLayer ? noteTint : inactiveTint, percent1);
-
-			localTint.a = tint.a * lerp(0.7, 1, lerp(startAlpha, endAlpha, percent1));
-
-			Vector2 p1{ xl1, y1 };
-			Vector2 p2{ xl1 + holdSliceSize, y1 };
-			Vector2 p3{ xl2, y2 };
-			Vector2 p4{ xl2 + holdSliceSize, y2 };
-			renderer->drawQuad(p1, p2, p3, p4, pathTex, left, left + holdSliceWidth, spr.getY(),
-			                   spr.getY() + spr.getHeight(), localTint);
-			p1.x = xl1 + holdSliceSize;
-			p2.x = xr1 - holdSliceSize;
-			p3.x = xl2 + holdSliceSize;
-			p4.x = xr2 - holdSliceSize;
-			renderer->drawQuad(p1, p2, p3, p4, pathTex, left + holdSliceWidth,
-			                   right - holdSliceWidth, spr.getY(), spr.getY() + spr.getHeight(),
-			                   localTint);
-			p1.x = xr1 - holdSliceSize;
-			p2.x = xr1;
-			p3.x = xr2 - holdSliceSize;
-			p4.x = xr2;
-			renderer->drawQuad(p1, p2, p3, p4, pathTex, right - holdSliceWidth, right, spr.getY(),
-			                   spr.getY() + spr.getHeight(), localTint);
+			renderer->drawQuads(&q, HoldCurveSegment::quadsPerStep, offsetY);
 		}
 	}
 
@@ -1861,12 +1934,27 @@ namespace MikuMikuWorld
 	void ScoreEditorTimeline::drawHoldNote(const std::unordered_map<int, Note>& notes,
 	                                       const HoldNote& note, Renderer* renderer,
 	                                       const Color& tint_, const int selectedLayer,
-	                                       const int offsetTicks, const int offsetLane)
+	                                       const int offsetTicks, const int offsetLane,
+	                                       std::vector<HoldCurveSegment>* curves)
 	{
 		const Note& start = notes.at(note.start.ID);
 		const Note& end = notes.at(note.end);
 		const int length = abs(end.tick - start.tick);
 		auto tint = tint_;
+
+		// Segments are drawn in order so the n-th curve drawn always uses the n-th cached segment
+		size_t segmentIndex = 0;
+		auto nextCurve = [curves, &segmentIndex]() -> HoldCurveSegment*
+		{
+			if (!curves)
+				return nullptr;
+
+			if (curves->size() <= segmentIndex)
+				curves->resize(segmentIndex + 1);
+
+			return &(*curves)[segmentIndex++];
+		};
+
 		if (note.steps.size())
 		{
 			static constexpr auto isSkipStep = [](const HoldStep& step)
@@ -1904,7 +1992,7 @@ namespace MikuMikuWorld
 						a2 = 1 - p2;
 					}
 					drawHoldCurve(n1, n2, ease, note.isGuide(), renderer, tint, offsetTicks,
-					              offsetLane, a1, a2, note.guideColor, selectedLayer);
+					              offsetLane, a1, a2, note.guideColor, selectedLayer, nextCurve());
 
 					s1 = s2;
 				}
@@ -1932,7 +2020,7 @@ namespace MikuMikuWorld
 				const Note& n1 = s1 == -1 ? start : notes.at(note.steps[s1].ID);
 				const EaseType ease = s1 == -1 ? note.start.ease : note.steps[s1].ease;
 				drawHoldCurve(n1, end, ease, note.isGuide(), renderer, tint, offsetTicks,
-				              offsetLane, a1, a2, note.guideColor, selectedLayer);
+				              offsetLane, a1, a2, note.guideColor, selectedLayer, nextCurve());
 			}
 
 			s1 = -1;
@@ -2035,7 +2123,7 @@ namespace MikuMikuWorld
 				a2 = 0;
 			}
 			drawHoldCurve(start, end, note.start.ease, note.isGuide(), renderer, tint, offsetTicks,
-			              offsetLane, a1, a2, note.guideColor, selectedLayer);
+			              offsetLane, a1, a2, note.guideColor, selectedLayer, nextCurve());
 		}
 
 		auto inactiveTint = tint * otherLayerTint;
@@ -2432,7 +2520,7 @@ namespace MikuMikuWorld
 
 			if (eventEdit.type == EventType::Bpm)
 			{
-				if (!isArrayIndexInBounds(eventEdit.editIndex, context.score.tempoChanges))
+				if (!isArrayIndexInBounds(eventEdit.editIndex, context.score.tempoChanges.get()))
 				{
 					ImGui::CloseCurrentPopup();
 					ImGui::EndPopup();
@@ -2441,19 +2529,20 @@ namespace MikuMikuWorld
 
 				UI::beginPropertyColumns();
 
-				Tempo& tempo = context.score.tempoChanges[eventEdit.editIndex];
 				UI::addFloatProperty(getString("bpm"), eventEdit.editBpm, "%g");
 				if (ImGui::IsItemDeactivatedAfterEdit())
 				{
 					Score prev = context.score;
+					Tempo& tempo = context.score.tempoChanges[eventEdit.editIndex];
 					tempo.bpm = std::clamp(eventEdit.editBpm, MIN_BPM, MAX_BPM);
+					context.tempoMap.invalidate();
 
 					context.pushHistory("Change tempo", prev, context.score);
 				}
 				UI::endPropertyColumns();
 
 				// cannot remove the first tempo change
-				if (tempo.tick != 0)
+				if (context.score.tempoChanges.get()[eventEdit.editIndex].tick != 0)
 				{
 					ImGui::Separator();
 					if (ImGui::Button(getString("remove"), ImVec2(-1, UI::btnSmall.y + 2)))
@@ -2462,6 +2551,7 @@ namespace MikuMikuWorld
 						Score prev = context.score;
 						context.score.tempoChanges.erase(context.score.tempoChanges.begin() +
 						                                 eventEdit.editIndex);
+						context.tempoMap.invalidate();
 						context.pushHistory("Remove tempo change", prev, context.score);
 					}
 				}
@@ -2486,6 +2576,7 @@ namespace MikuMikuWorld
 					                          MIN_TIME_SIGNATURE, MAX_TIME_SIGNATURE_NUMERATOR);
 					ts.denominator = std::clamp(abs(eventEdit.editTimeSignatureDenominator),
 					                            MIN_TIME_SIGNATURE, MAX_TIME_SIGNATURE_DENOMINATOR);
+					context.measureTable.invalidate();
 
 					context.pushHistory("Change time signature", prev, context.score);
 				}
@@ -2500,14 +2591,14 @@ namespace MikuMikuWorld
 						ImGui::CloseCurrentPopup();
 						Score prev = context.score;
 						context.score.timeSignatures.erase(eventEdit.editIndex);
+						context.measureTable.invalidate();
 						context.pushHistory("Remove time signature", prev, context.score);
 					}
 				}
 			}
 			else if (eventEdit.type == EventType::HiSpeed)
 			{
-				if (context.score.hiSpeedChanges.find(eventEdit.editIndex) ==
-				    context.score.hiSpeedChanges.end())
+				if (!context.score.hiSpeedChanges.count(eventEdit.editIndex))
 				{
 					ImGui::CloseCurrentPopup();
 					ImGui::EndPopup();
@@ -2516,10 +2607,10 @@ namespace MikuMikuWorld
 
 				UI::beginPropertyColumns();
 				UI::addFloatProperty(getString("hi_speed_speed"), eventEdit.editHiSpeed, "%g");
-				HiSpeedChange& hiSpeed = context.score.hiSpeedChanges[eventEdit.editIndex];
 				if (ImGui::IsItemDeactivatedAfterEdit())
 				{
 					Score prev = context.score;
+					HiSpeedChange& hiSpeed = context.score.hiSpeedChanges[eventEdit.editIndex];
 					hiSpeed.speed = eventEdit.editHiSpeed;
 
 					context.pushHistory("Change hi-speed", prev, context.score);
@@ -2746,8 +2837,8 @@ namespace MikuMikuWorld
 			ImGui::Text("Hovering note ID: %d", hoveringNote);
 			ImGui::Text("Holding note ID: %d", holdingNote);
 
-			auto it = context.score.notes.find(hoveringNote);
-			if (it != context.score.notes.end())
+			auto it = context.score.notes.get().find(hoveringNote);
+			if (it != context.score.notes.get().end())
 			{
 				const Note& note = it->second;
 				ImGui::Text("ID: %d\nType: %d\nTick: %d\nLane: %d\nWidth: %d\nCritical: "
@@ -2834,11 +2925,13 @@ namespace MikuMikuWorld
 			bool playSE = true;
 			if (note.getType() == NoteType::Hold)
 			{
-				playSE = context.score.holdNotes.at(note.ID).startType == HoldNoteType::Normal;
+				playSE = context.score.holdNotes.get().at(note.ID).startType ==
+				         HoldNoteType::Normal;
 			}
 			else if (note.getType() == NoteType::HoldEnd)
 			{
-				playSE = context.score.holdNotes.at(note.parentID).endType == HoldNoteType::Normal;
+				playSE = context.score.holdNotes.get().at(note.parentID).endType ==
+				         HoldNoteType::Normal;
 			}
 
 			if (playSE)
@@ -2855,8 +2948,9 @@ namespace MikuMikuWorld
 
 		static auto holdNoteSEFunc = [&context, this](const Note& note, float startTime)
 		{
-			int endTick = context.score.notes.at(context.score.holdNotes.at(note.ID).end).tick;
-			float endTime = accumulateDuration(endTick, TICKS_PER_BEAT, context.score.tempoChanges);
+			int endID = context.score.holdNotes.get().at(note.ID).end;
+			int endTick = context.score.notes.get().at(endID).tick;
+			float endTime = context.tempoMap.ticksToSeconds(endTick, context.score.tempoChanges);
 
 			float adjustedEndTime = endTime - playStartTime + audioOffsetCorrection;
 			context.audio.playSoundEffect(note.critical ? SE_CRITICAL_CONNECT : SE_CONNECT,
@@ -2864,10 +2958,9 @@ namespace MikuMikuWorld
 		};
 
 		playingNoteSounds.clear();
-		for (const auto& [id, note] : context.score.notes)
+		for (const auto& [id, note] : context.score.notes.get())
 		{
-			float noteTime =
-			    accumulateDuration(note.tick, TICKS_PER_BEAT, context.score.tempoChanges);
+			float noteTime = context.tempoMap.ticksToSeconds(note.tick, context.score.tempoChanges);
 			float notePlayTime = noteTime - playStartTime;
 			float offsetNoteTime = noteTime - (audioLookAhead * playbackSpeed);
 
@@ -2875,7 +2968,7 @@ namespace MikuMikuWorld
 			{
 				singleNoteSEFunc(note, notePlayTime - audioOffsetCorrection);
 				if (note.getType() == NoteType::Hold &&
-				    !context.score.holdNotes.at(note.ID).isGuide())
+				    !context.score.holdNotes.get().at(note.ID).isGuide())
 					holdNoteSEFunc(note, notePlayTime - audioOffsetCorrection);
 			}
 			else if (time == playStartTime)
@@ -2886,12 +2979,12 @@ namespace MikuMikuWorld
 
 				// Playback started mid-hold
 				if (note.getType() == NoteType::Hold &&
-				    !context.score.holdNotes.at(note.ID).isGuide())
+				    !context.score.holdNotes.get().at(note.ID).isGuide())
 				{
-					int endTick =
-					    context.score.notes.at(context.score.holdNotes.at(note.ID).end).tick;
+					int endID = context.score.holdNotes.get().at(note.ID).end;
+					int endTick = context.score.notes.get().at(endID).tick;
 					float endTime =
-					    accumulateDuration(endTick, TICKS_PER_BEAT, context.score.tempoChanges);
+					    context.tempoMap.ticksToSeconds(endTick, context.score.tempoChanges);
 					if ((noteTime - time) <= audioLookAhead && endTime > time)
 						holdNoteSEFunc(note, std::max(0.0f, notePlayTime));
 				}
@@ -2932,7 +3025,7 @@ namespace MikuMikuWorld
 
 				// Small accuracy loss by converting to ticks but shouldn't be too noticeable
 				const double secondsAtPixel =
-				    accumulateDuration(tick, TICKS_PER_BEAT, context.score.tempoChanges) -
+				    context.tempoMap.ticksToSeconds(tick, context.score.tempoChanges) -
 				    musicOffsetInSeconds;
 				const bool outOfBounds =
 				    secondsAtPixel < 0 || secondsAtPixel > waveform.durationInSeconds;
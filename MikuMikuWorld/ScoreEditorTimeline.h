@@ -165,6 +165,8 @@ namespace MikuMikuWorld
 		} noteTransformOrigin;
 
 		std::vector<StepDrawData> drawSteps;
+		// Tessellation of curves that are not part of the score, like the hold being inserted
+		HoldCurveSegment uncachedCurve;
 		std::unordered_set<std::string> playingNoteSounds;
 		static constexpr float audioOffsetCorrection = 0.02f;
 		static constexpr float audioLookAhead = 0.05f;
@@ -179,10 +181,12 @@ namespace MikuMikuWorld
 		                   const int offsetLane = 0, const float startAlpha = 1,
 		                   const float endAlpha = 1,
 		                   const GuideColor guideColor = GuideColor::Green,
-		                   const int selectedLayer = -1);
+		                   const int selectedLayer = -1, HoldCurveSegment* curve = nullptr);
+		// Pass the hold's cached segments to reuse their tessellation between frames
 		void drawHoldNote(const std::unordered_map<int, Note>& notes, const HoldNote& note,
 		                  Renderer* renderer, const Color& tint, const int selectedLayer = -1,
-		                  const int offsetTicks = 0, const int offsetLane = 0);
+		                  const int offsetTicks = 0, const int offsetLane = 0,
+		                  std::vector<HoldCurveSegment>* curves = nullptr);
 		void drawHoldMid(Note& note, HoldStepType type, Renderer* renderer, const Color& tint,
 		                 const bool selectedLayer = true);
 		void drawOutline(const StepDrawData& data, const int selectedLayer = -1);
@@ -288,7 +292,7 @@ namespace MikuMikuWorld
 
 		void update(ScoreContext& context, EditArgs& edit, Renderer* renderer);
 		void updateNotes(ScoreContext& context, EditArgs& edit, Renderer* renderer);
-		void updateNote(ScoreContext& context, EditArgs& edit, Note& note);
+		void updateNote(ScoreContext& context, EditArgs& edit, int noteID);
 		void updateInputNotes(const Score& score, EditArgs& edit);
 		void debug(ScoreContext& context);
 
@@ -3,9 +3,11 @@
 #include "ApplicationConfiguration.h"
 #include "Constants.h"
 #include "File.h"
+#include "FileDialog.h"
 #include "ScoreContext.h"
 #include "UI.h"
 #include "Utilities.h"
+#include <optional>
 
 namespace MikuMikuWorld
 {
@@ -125,8 +127,15 @@ namespace MikuMikuWorld
 			return;
 		}
 
-		Score prev = context.score;
-		bool edited = false;
+		// Widgets read through the const score and edit copies, the score is only written once an
+		// edit happened. Non-const access while a snapshot shares the score copies its containers
+		const Score& score = context.score;
+		std::optional<Score> prev;
+		auto beginEdit = [&context, &prev]()
+		{
+			if (!prev)
+				prev = context.score;
+		};
 
 		int selectedTick;
 		int selectedLayer;
@@ -134,13 +143,12 @@ namespace MikuMikuWorld
 		{
 			selectedTick =
 			    context.selectedNotes.size() >= 1
-			        ? context.score.notes.at(*context.selectedNotes.begin()).tick
-			        : context.score.hiSpeedChanges.at(*context.selectedHiSpeedChanges.begin()).tick;
+			        ? score.notes.at(*context.selectedNotes.begin()).tick
+			        : score.hiSpeedChanges.at(*context.selectedHiSpeedChanges.begin()).tick;
 			selectedLayer =
 			    context.selectedNotes.size() >= 1
-			        ? context.score.notes.at(*context.selectedNotes.begin()).layer
-			        : context.score.hiSpeedChanges.at(*context.selectedHiSpeedChanges.begin())
-			              .layer;
+			        ? score.notes.at(*context.selectedNotes.begin()).layer
+			        : score.hiSpeedChanges.at(*context.selectedHiSpeedChanges.begin()).layer;
 		}
 		catch (const std::out_of_range& e)
 		{
@@ -156,6 +164,7 @@ namespace MikuMikuWorld
 			double beat = selectedTick / static_cast<float>(TICKS_PER_BEAT);
 			if (UI::addDoubleProperty(getString("beat"), beat, "%.3f"))
 			{
+				beginEdit();
 				auto newTick = std::floor(beat * TICKS_PER_BEAT);
 				for (auto& id : context.selectedNotes)
 				{
@@ -165,13 +174,13 @@ namespace MikuMikuWorld
 				{
 					context.score.hiSpeedChanges.at(id).tick = newTick;
 				}
-				edited = true;
 			}
 
 			if (config.showTickInProperties)
 			{
 				if (UI::addIntProperty(getString("tick"), selectedTick))
 				{
+					beginEdit();
 					for (auto& id : context.selectedNotes)
 					{
 						context.score.notes.at(id).tick = selectedTick;
@@ -180,20 +189,20 @@ namespace MikuMikuWorld
 					{
 						context.score.hiSpeedChanges.at(id).tick = selectedTick;
 					}
-					edited = true;
 				}
 			}
 
 			UI::propertyLabel(getString("layer"));
-			const std::string layer_name = context.score.layers[selectedLayer].name;
+			const std::string layer_name = score.layers[selectedLayer].name;
 			if (ImGui::BeginCombo(IO::concat("##", getString("layer")).c_str(), layer_name.c_str()))
 			{
-				for (int i = 0; i < context.score.layers.size(); i++)
+				for (int i = 0; i < score.layers.size(); i++)
 				{
-					auto& layer = context.score.layers[i];
+					auto& layer = score.layers[i];
 					bool selected = selectedLayer == i;
 					if (ImGui::Selectable(layer.name.c_str(), selected))
 					{
+						beginEdit();
 						for (auto& id : context.selectedNotes)
 						{
 							context.score.notes.at(id).layer = i;
@@ -202,7 +211,6 @@ namespace MikuMikuWorld
 						{
 							context.score.hiSpeedChanges.at(id).layer = i;
 						}
-						edited = true;
 					}
 				}
 				ImGui::EndCombo();
@@ -219,7 +227,7 @@ namespace MikuMikuWorld
 			int holdIndex = -1;
 			for (int id : context.selectedNotes)
 			{
-				const Note& n = context.score.notes.at(id);
+				const Note& n = score.notes.at(id);
 				if (n.isHold())
 				{
 					auto prevHoldIndex = holdIndex;
@@ -239,7 +247,8 @@ namespace MikuMikuWorld
 				}
 			}
 
-			Note& note = context.score.notes.at(*context.selectedNotes.begin());
+			// The widgets edit this copy, the edited values are then written to the selection
+			Note note = score.notes.at(*context.selectedNotes.begin());
 			if (ImGui::CollapsingHeader(
 			        IO::concat(ICON_FA_COG, getString("note_properties_note"), " ").c_str(),
 			        ImGuiTreeNodeFlags_DefaultOpen))
@@ -248,22 +257,24 @@ namespace MikuMikuWorld
 
 				if (UI::addFloatProperty(getString("lane"), note.lane, "%.2f"))
 				{
+					beginEdit();
 					for (auto& id : context.selectedNotes)
 					{
 						context.score.notes.at(id).lane = note.lane;
 					}
-					edited = true;
 				}
 
 				if (UI::addFloatProperty(getString("width"), note.width, "%.2f"))
 				{
+					beginEdit();
 					for (auto& id : context.selectedNotes)
 					{
 						auto& localNote = context.score.notes.at(id);
 						if (localNote.isHold())
 						{
-							auto& hold = context.score.holdNotes.at(
-							    localNote.parentID == -1 ? id : localNote.parentID);
+							auto& hold = score.holdNotes.at(localNote.parentID == -1
+							                                    ? id
+							                                    : localNote.parentID);
 							if (hold.isGuide())
 							{
 								localNote.width = std::max(0.0f, note.width);
@@ -273,7 +284,6 @@ namespace MikuMikuWorld
 
 						localNote.width = std::max(0.5f, note.width);
 					}
-					edited = true;
 				}
 			}
 
@@ -281,19 +291,21 @@ namespace MikuMikuWorld
 			{
 				if (!multipleHold)
 				{
-					auto& hold = context.score.holdNotes.at(holdIndex);
-					auto& holdStart = context.score.notes.at(hold.start.ID);
+					const HoldNote& hold = score.holdNotes.at(holdIndex);
 
 					isGuide = hold.isGuide();
 					if (note.width == 0 && !isGuide)
 					{
-						if (note.getType() == NoteType::Hold)
+						// Not recorded as an edit of its own, only written when it changes
+						if (note.getType() == NoteType::Hold &&
+						    hold.startType != HoldNoteType::Hidden)
 						{
-							hold.startType = HoldNoteType::Hidden;
+							context.score.holdNotes.at(holdIndex).startType = HoldNoteType::Hidden;
 						}
-						else if (note.getType() == NoteType::HoldEnd)
+						else if (note.getType() == NoteType::HoldEnd &&
+						         hold.endType != HoldNoteType::Hidden)
 						{
-							hold.endType = HoldNoteType::Hidden;
+							context.score.holdNotes.at(holdIndex).endType = HoldNoteType::Hidden;
 						}
 					}
 
@@ -303,6 +315,7 @@ namespace MikuMikuWorld
 						{
 							if (UI::addCheckboxProperty(getString("trace"), note.friction))
 							{
+								beginEdit();
 								for (auto& id : context.selectedNotes)
 								{
 									auto& n = context.score.notes.at(id);
@@ -311,11 +324,11 @@ namespace MikuMikuWorld
 										n.friction = note.friction;
 									}
 								}
-								edited = true;
 							}
 						}
 						if (UI::addCheckboxProperty(getString("critical"), note.critical))
 						{
+							beginEdit();
 							context.score.notes.at(hold.start.ID).critical = note.critical;
 							for (auto& step : hold.steps)
 							{
@@ -326,7 +339,6 @@ namespace MikuMikuWorld
 							{
 								context.score.notes.at(id).critical = note.critical;
 							}
-							edited = true;
 						}
 					}
 
@@ -335,6 +347,8 @@ namespace MikuMikuWorld
 						if (UI::addFlickSelectPropertyWithNone(getString("flick"), note.flick,
 						                                       flickTypes, arrayLength(flickTypes)))
 						{
+							beginEdit();
+							context.score.notes.at(note.ID).flick = note.flick;
 							context.score.notes.at(hold.start.ID).flick = note.flick;
 							for (auto& id : context.selectedNotes)
 							{
@@ -352,6 +366,7 @@ namespace MikuMikuWorld
 			{
 				if (UI::addCheckboxProperty(getString("trace"), note.friction))
 				{
+					beginEdit();
 					for (auto& id : context.selectedNotes)
 					{
 						auto& n = context.score.notes.at(id);
@@ -360,19 +375,19 @@ namespace MikuMikuWorld
 							n.friction = note.friction;
 						}
 					}
-					edited = true;
 				}
 				if (UI::addCheckboxProperty(getString("critical"), note.critical))
 				{
+					beginEdit();
 					for (auto& id : context.selectedNotes)
 					{
 						context.score.notes.at(id).critical = note.critical;
 					}
-					edited = true;
 				}
 				if (UI::addFlickSelectPropertyWithNone(getString("flick"), note.flick, flickTypes,
 				                                       arrayLength(flickTypes)))
 				{
+					beginEdit();
 					for (auto& id : context.selectedNotes)
 					{
 						auto& n = context.score.notes.at(id);
@@ -381,7 +396,6 @@ namespace MikuMikuWorld
 							n.flick = note.flick;
 						}
 					}
-					edited = true;
 				}
 			}
 
@@ -403,10 +417,7 @@ namespace MikuMikuWorld
 					}
 					else
 					{
-						auto& hold = context.score.holdNotes.at(holdIndex);
-						auto& holdStart = context.score.notes.at(hold.start.ID);
-
-						int stepIndex = findHoldStep(hold, note.ID);
+						const HoldNote& hold = score.holdNotes.at(holdIndex);
 
 						UI::beginPropertyColumns();
 
@@ -416,7 +427,7 @@ namespace MikuMikuWorld
 						Note stepTypeNote;
 						for (auto id : context.selectedNotes)
 						{
-							auto& n = context.score.notes.at(id);
+							const Note& n = score.notes.at(id);
 							if (n.hasEase())
 							{
 								if (!hasEaseable)
@@ -425,7 +436,7 @@ namespace MikuMikuWorld
 								}
 								hasEaseable = true;
 							}
-							if (context.score.notes.at(id).getType() == NoteType::HoldMid)
+							if (n.getType() == NoteType::HoldMid)
 							{
 								if (!hasStepType)
 								{
@@ -444,18 +455,21 @@ namespace MikuMikuWorld
 							if (UI::addSelectProperty(getString("ease_type"), ease, easeTypes,
 							                          arrayLength(easeTypes)))
 							{
+								beginEdit();
+								HoldNote& editHold = context.score.holdNotes.at(holdIndex);
 								for (auto id : context.selectedNotes)
 								{
-									auto& note = context.score.notes.at(id);
+									const Note& note = score.notes.at(id);
 									if (note.hasEase())
 									{
 										if (note.getType() == NoteType::Hold)
 										{
-											hold.start.ease = ease;
+											editHold.start.ease = ease;
 										}
 										else
 										{
-											auto& step = hold.steps.at(findHoldStep(hold, note.ID));
+											auto& step =
+											    editHold.steps.at(findHoldStep(editHold, note.ID));
 											step.ease = ease;
 										}
 									}
@@ -471,12 +485,15 @@ namespace MikuMikuWorld
 							if (UI::addSelectProperty(getString("step_type"), stepType, stepTypes,
 							                          arrayLength(stepTypes)))
 							{
+								beginEdit();
+								HoldNote& editHold = context.score.holdNotes.at(holdIndex);
 								for (auto id : context.selectedNotes)
 								{
-									auto& note = context.score.notes.at(id);
+									const Note& note = score.notes.at(id);
 									if (note.getType() == NoteType::HoldMid)
 									{
-										auto& step = hold.steps.at(findHoldStep(hold, note.ID));
+										auto& step =
+										    editHold.steps.at(findHoldStep(editHold, note.ID));
 										step.type = stepType;
 									}
 								}
@@ -485,11 +502,22 @@ namespace MikuMikuWorld
 
 						if (isGuide)
 						{
-							edited |= UI::addSelectProperty(getString("guide_color"),
-							                                hold.guideColor, guideColorsForString,
-							                                arrayLength(guideColors));
-							edited |= UI::addSelectProperty(getString("fade_type"), hold.fadeType,
-							                                fadeTypes, arrayLength(fadeTypes));
+							GuideColor guideColor = hold.guideColor;
+							if (UI::addSelectProperty(getString("guide_color"), guideColor,
+							                          guideColorsForString,
+							                          arrayLength(guideColors)))
+							{
+								beginEdit();
+								context.score.holdNotes.at(holdIndex).guideColor = guideColor;
+							}
+
+							FadeType fadeType = hold.fadeType;
+							if (UI::addSelectProperty(getString("fade_type"), fadeType, fadeTypes,
+							                          arrayLength(fadeTypes)))
+							{
+								beginEdit();
+								context.score.holdNotes.at(holdIndex).fadeType = fadeType;
+							}
 						}
 						else
 						{
@@ -498,19 +526,20 @@ namespace MikuMikuWorld
 							if (UI::addSelectProperty(getString("hold_type"), holdType, holdTypes,
 							                          2))
 							{
+								beginEdit();
+								HoldNote& editHold = context.score.holdNotes.at(holdIndex);
 								for (auto id : context.selectedNotes)
 								{
-									auto& note = context.score.notes.at(id);
+									const Note& note = score.notes.at(id);
 									if (note.getType() == NoteType::Hold)
 									{
-										hold.startType = holdType;
+										editHold.startType = holdType;
 									}
 									else
 									{
-										hold.endType = holdType;
+										editHold.endType = holdType;
 									}
 								}
-								edited = true;
 							}
 						}
 					}
@@ -521,8 +550,8 @@ namespace MikuMikuWorld
 		}
 		if (context.selectedHiSpeedChanges.size() >= 1)
 		{
-			HiSpeedChange& hiSpeed =
-			    context.score.hiSpeedChanges.at(*context.selectedHiSpeedChanges.begin());
+			const int hiSpeedID = *context.selectedHiSpeedChanges.begin();
+			float speed = score.hiSpeedChanges.at(hiSpeedID).speed;
 			if (ImGui::CollapsingHeader(
 			        IO::concat(ICON_FA_FAST_FORWARD, getString("note_properties_hi_speed"), " ")
 			            .c_str(),
@@ -530,18 +559,18 @@ namespace MikuMikuWorld
 			{
 				UI::beginPropertyColumns();
 
-				if (UI::addFloatProperty(getString("hi_speed"), hiSpeed.speed, "%.3f"))
+				if (UI::addFloatProperty(getString("hi_speed"), speed, "%.3f"))
 				{
-					hiSpeed.speed = hiSpeed.speed;
-					edited = true;
+					beginEdit();
+					context.score.hiSpeedChanges.at(hiSpeedID).speed = speed;
 				}
 
 				UI::endPropertyColumns();
 			}
 		}
 
-		if (edited)
-			context.pushHistory("Edited object", prev, context.score);
+		if (prev)
+			context.pushHistory("Edited object", *prev, context.score);
 	}
 
 	void ScoreOptionsWindow::update(ScoreContext& context, EditArgs& edit, TimelineMode currentMode)
@@ -929,7 +958,8 @@ namespace MikuMikuWorld
 		return DialogResult::None;
 	}
 
-	void DebugWindow::update(ScoreContext& context, ScoreEditorTimeline& timeline)
+	void DebugWindow::update(ScoreContext& context, ScoreEditorTimeline& timeline,
+	                         Renderer& renderer)
 	{
 		if (ImGui::Begin(IMGUI_TITLE(ICON_FA_BUG, "debug")))
 		{
@@ -1072,6 +1102,21 @@ namespace MikuMikuWorld
 				timeline.debug(context);
 				ImGui::TreePop();
 			}
+
+			if (ImGui::TreeNodeEx("Renderer", treeNodeFlags))
+			{
+				UI::beginPropertyColumns();
+				UI::addReadOnlyProperty("Quads", renderer.getNumQuads());
+				UI::addReadOnlyProperty("Vertices", renderer.getNumVertices());
+				UI::addReadOnlyProperty("Draw Calls", renderer.getNumDrawCalls());
+
+				VertexStreamMode streamMode = renderer.getStreamMode();
+				if (UI::addSelectProperty("Vertex Streaming", streamMode, vertexStreamModes,
+				                          (int)VertexStreamMode::VertexStreamModeCount))
+					renderer.setStreamMode(streamMode);
+				UI::endPropertyColumns();
+				ImGui::TreePop();
+			}
 		}
 
 		ImGui::End();
@@ -1310,6 +1355,8 @@ namespace MikuMikuWorld
 						UI::beginPropertyColumns();
 						UI::addCheckboxProperty(getString("minify_usc"), config.minifyUsc);
 						UI::addCheckboxProperty(getString("show_sus_export"), config.showSusExport);
+						UI::addCheckboxProperty(getString("compact_mmws"),
+						                        config.compactScoreFiles);
 						UI::endPropertyColumns();
 					}
 
@@ -1322,6 +1369,21 @@ namespace MikuMikuWorld
 						UI::addIntProperty(getString("auto_save_interval"),
 						                   config.autoSaveInterval);
 						UI::addIntProperty(getString("auto_save_count"), config.autoSaveMaxCount);
+						UI::addCheckboxProperty(getString("auto_save_journal"),
+						                        config.autoSaveJournal);
+						UI::addIntProperty(getString("auto_save_journal_compact"),
+						                   config.autoSaveJournalCompactCount);
+						UI::endPropertyColumns();
+					}
+
+					if (ImGui::CollapsingHeader(getString("history"),
+					                            ImGuiTreeNodeFlags_DefaultOpen))
+					{
+						UI::beginPropertyColumns();
+						UI::addIntProperty(getString("history_memory_limit"),
+						                   config.historyMemoryLimit);
+						UI::addCheckboxProperty(getString("history_merge_entries"),
+						                        config.mergeHistoryEntries);
 						UI::endPropertyColumns();
 					}
 
@@ -1745,6 +1807,7 @@ namespace MikuMikuWorld
 				context.score.hiSpeedChanges[id] = {
 					id, 0, 1, static_cast<int>(context.score.layers.size()) - 1
 				};
+				context.hiSpeedTimeline.invalidate();
 				layerName.clear();
 			}
 		}
@@ -53,7 +53,7 @@ namespace MikuMikuWorld
 	class DebugWindow
 	{
 	  public:
-		void update(ScoreContext& context, ScoreEditorTimeline& timeline);
+		void update(ScoreContext& context, ScoreEditorTimeline& timeline, Renderer& renderer);
 	};
 
 	class SettingsWindow
@@ -0,0 +1,189 @@
+#include "ScoreIndex.h"
+#include "Score.h"
+#include <algorithm>
+#include <climits>
+
+namespace MikuMikuWorld
+{
+	namespace
+	{
+		// Entries and intervals are ordered by tick first and by ID for a stable order
+		constexpr auto compareEntries = [](const auto& a, const auto& b)
+		{ return a.tick == b.tick ? a.ID < b.ID : a.tick < b.tick; };
+
+		constexpr auto compareIntervals = [](const auto& a, const auto& b)
+		{ return a.startTick == b.startTick ? a.ID < b.ID : a.startTick < b.startTick; };
+	}
+
+	void NoteTickIndex::rebuild(const Score& score)
+	{
+		entries.clear();
+		entries.reserve(score.notes.size());
+		for (const auto& [id, note] : score.notes)
+			entries.push_back({ note.tick, id });
+
+		std::sort(entries.begin(), entries.end(), compareEntries);
+		dirty = false;
+	}
+
+	void NoteTickIndex::update(const Score& score, const std::unordered_set<int>& noteIDs)
+	{
+		if (dirty)
+			return;
+
+		// Take the moved entries out and merge them back in at their new ticks
+		entries.erase(std::remove_if(entries.begin(), entries.end(),
+		                             [&noteIDs](const Entry& e) { return noteIDs.count(e.ID); }),
+		              entries.end());
+
+		const size_t kept = entries.size();
+		for (int id : noteIDs)
+		{
+			auto it = score.notes.find(id);
+			if (it != score.notes.end())
+				entries.push_back({ it->second.tick, id });
+		}
+
+		std::sort(entries.begin() + kept, entries.end(), compareEntries);
+		std::inplace_merge(entries.begin(), entries.begin() + kept, entries.end(), compareEntries);
+	}
+
+	std::vector<int> NoteTickIndex::notesInRange(const Score& score, int minTick, int maxTick)
+	{
+		if (dirty)
+			rebuild(score);
+
+		std::vector<int> result;
+		auto first = std::lower_bound(entries.begin(), entries.end(), minTick,
+		                              [](const Entry& e, int tick) { return e.tick < tick; });
+		for (auto it = first; it != entries.end() && it->tick <= maxTick; ++it)
+			result.push_back(it->ID);
+
+		return result;
+	}
+
+	bool HoldIntervalIndex::getInterval(const Score& score, int holdID, Interval& interval) const
+	{
+		auto holdIt = score.holdNotes.find(holdID);
+		if (holdIt == score.holdNotes.end())
+			return false;
+
+		// Steps are included since they may temporarily lie outside the hold while being dragged
+		const HoldNote& hold = holdIt->second;
+		interval = { INT_MAX, INT_MIN, holdID };
+		for (int index = -1; index <= (int)hold.steps.size(); ++index)
+		{
+			auto it = score.notes.find(hold.id_at(index));
+			if (it == score.notes.end())
+				continue;
+
+			interval.startTick = std::min(interval.startTick, it->second.tick);
+			interval.endTick = std::max(interval.endTick, it->second.tick);
+		}
+
+		return interval.startTick <= interval.endTick;
+	}
+
+	void HoldIntervalIndex::rebuild(const Score& score)
+	{
+		intervals.clear();
+		intervals.reserve(score.holdNotes.size());
+		for (const auto& [id, hold] : score.holdNotes)
+		{
+			Interval interval;
+			if (getInterval(score, id, interval))
+				intervals.push_back(interval);
+		}
+
+		std::sort(intervals.begin(), intervals.end(), compareIntervals);
+		maxEndTicks.assign(intervals.size(), INT_MIN);
+		buildNode(0, intervals.size());
+		dirty = false;
+	}
+
+	void HoldIntervalIndex::update(const Score& score, const std::unordered_set<int>& noteIDs)
+	{
+		if (dirty)
+			return;
+
+		std::unordered_set<int> holdIDs;
+		for (int id : noteIDs)
+		{
+			auto it = score.notes.find(id);
+			if (it == score.notes.end())
+				continue;
+
+			const Note& note = it->second;
+			if (note.getType() == NoteType::Hold)
+				holdIDs.insert(id);
+			else if (note.getType() == NoteType::HoldMid || note.getType() == NoteType::HoldEnd)
+				holdIDs.insert(note.parentID);
+		}
+
+		if (holdIDs.empty())
+			return;
+
+		// Like the note index, only the max end ticks need a full pass afterwards
+		auto moved = [&holdIDs](const Interval& i) { return holdIDs.count(i.ID); };
+		intervals.erase(std::remove_if(intervals.begin(), intervals.end(), moved), intervals.end());
+
+		const size_t kept = intervals.size();
+		for (int id : holdIDs)
+		{
+			Interval interval;
+			if (getInterval(score, id, interval))
+				intervals.push_back(interval);
+		}
+
+		std::sort(intervals.begin() + kept, intervals.end(), compareIntervals);
+		std::inplace_merge(intervals.begin(), intervals.begin() + kept, intervals.end(),
+		                   compareIntervals);
+
+		maxEndTicks.assign(intervals.size(), INT_MIN);
+		buildNode(0, intervals.size());
+	}
+
+	int HoldIntervalIndex::buildNode(int begin, int end)
+	{
+		if (begin >= end)
+			return INT_MIN;
+
+		int mid = begin + (end - begin) / 2;
+		maxEndTicks[mid] = std::max(
+		    { intervals[mid].endTick, buildNode(begin, mid), buildNode(mid + 1, end) });
+		return maxEndTicks[mid];
+	}
+
+	void HoldIntervalIndex::queryNode(int begin, int end, int minTick, int maxTick,
+	                                  std::vector<int>& result) const
+	{
+		if (begin >= end)
+			return;
+
+		// Nothing in this subtree reaches the queried range
+		int mid = begin + (end - begin) / 2;
+		if (maxEndTicks[mid] < minTick)
+			return;
+
+		queryNode(begin, mid, minTick, maxTick, result);
+
+		// Intervals to the right start even later
+		if (intervals[mid].startTick > maxTick)
+			return;
+
+		if (intervals[mid].endTick >= minTick)
+			result.push_back(intervals[mid].ID);
+
+		queryNode(mid + 1, end, minTick, maxTick, result);
+	}
+
+	std::vector<int> HoldIntervalIndex::holdsInRange(const Score& score, int minTick, int maxTick)
+	{
+		if (dirty)
+			rebuild(score);
+
+		std::vector<int> result;
+		queryNode(0, intervals.size(), minTick, maxTick, result);
+		return result;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <unordered_set>
+#include <vector>
+
+namespace MikuMikuWorld
+{
+	struct Score;
+
+	/**
+	 * @brief Tick-ordered index over `Score::notes` used to answer range queries without
+	 *        scanning the whole note map
+	 * @note The index is rebuilt lazily on the next query after `invalidate()` is called,
+	 *       so every code path that adds or removes notes must invalidate it. Moved notes can
+	 *       be updated in place with `update()` instead
+	 */
+	class NoteTickIndex
+	{
+	  private:
+		struct Entry
+		{
+			int tick;
+			int ID;
+		};
+
+		std::vector<Entry> entries;
+		bool dirty{ true };
+
+		void rebuild(const Score& score);
+
+	  public:
+		inline void invalidate() { dirty = true; }
+
+		// Moves the entries of the given notes to their current ticks in linear time
+		void update(const Score& score, const std::unordered_set<int>& noteIDs);
+
+		// Returns the IDs of all notes whose tick lies within [minTick, maxTick] in ascending tick order
+		std::vector<int> notesInRange(const Score& score, int minTick, int maxTick);
+	};
+
+	/**
+	 * @brief Interval index over `Score::holdNotes` keyed on the tick range each hold spans
+	 * @note Implemented as an implicit balanced search tree over the intervals sorted by their
+	 *       start tick, where every node also stores the largest end tick of its subtree.
+	 *       Like `NoteTickIndex` it is rebuilt lazily after `invalidate()` and updated in place
+	 *       after notes are moved
+	 */
+	class HoldIntervalIndex
+	{
+	  private:
+		struct Interval
+		{
+			int startTick;
+			int endTick;
+			int ID;
+		};
+
+		std::vector<Interval> intervals;
+		// The largest end tick within the subtree rooted at the same index in `intervals`
+		std::vector<int> maxEndTicks;
+		bool dirty{ true };
+
+		void rebuild(const Score& score);
+		bool getInterval(const Score& score, int holdID, Interval& interval) const;
+		int buildNode(int begin, int end);
+		void queryNode(int begin, int end, int minTick, int maxTick, std::vector<int>& result) const;
+
+	  public:
+		inline void invalidate() { dirty = true; }
+
+		// Updates the intervals of the holds the given notes belong to in linear time
+		void update(const Score& score, const std::unordered_set<int>& noteIDs);
+
+		// Returns the IDs of all holds whose tick range overlaps [minTick, maxTick] in ascending start tick order
+		std::vector<int> holdsInRange(const Score& score, int minTick, int maxTick);
+	};
+}
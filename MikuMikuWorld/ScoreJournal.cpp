@@ -0,0 +1,533 @@
+#include "ScoreJournal.h"
+#include "BinaryReader.h"
+#include "BinaryWriter.h"
+#include "Constants.h"
+#include "File.h"
+#include "IO.h"
+#include <algorithm>
+#include <climits>
+#include <memory>
+
+using namespace IO;
+
+namespace MikuMikuWorld
+{
+	constexpr const char* JOURNAL_SIGNATURE = "MMWJ";
+	constexpr uint16_t JOURNAL_VERSION = 3;
+
+	// Maps IDs written in the journal to IDs of the loaded score, allocating new IDs for elements
+	// that were created after the base file was written
+	class JournalIDMap
+	{
+	  private:
+		std::unordered_map<int, int> ids;
+		int& next;
+
+	  public:
+		JournalIDMap(int& _next) : next{ _next } {}
+
+		inline void set(int journalID, int scoreID) { ids[journalID] = scoreID; }
+
+		int get(int journalID)
+		{
+			if (journalID < 0)
+				return journalID;
+
+			auto [it, inserted] = ids.try_emplace(journalID, next);
+			if (inserted)
+				++next;
+
+			return it->second;
+		}
+	};
+
+	struct JournalIDs
+	{
+		JournalIDMap notes{ nextID };
+		JournalIDMap hiSpeeds{ nextHiSpeedID };
+		JournalIDMap skills{ nextSkillID };
+	};
+
+	// Every element takes at least one byte, which bounds counts read from a damaged journal
+	static size_t readCount(BinaryReader& reader)
+	{
+		size_t count = reader.readUInt32();
+		return std::min(count, reader.getFileSize() - reader.getStreamPosition());
+	}
+
+	static void writeNote(const Note& note, BinaryWriter& writer)
+	{
+		writer.writeInt32((int)note.getType());
+		writer.writeInt32(note.ID);
+		writer.writeInt32(note.parentID);
+		writer.writeInt32(note.tick);
+		writer.writeSingle(note.lane);
+		writer.writeSingle(note.width);
+		writer.writeInt32(note.critical);
+		writer.writeInt32(note.friction);
+		writer.writeInt32((int)note.flick);
+		writer.writeInt32(note.layer);
+	}
+
+	static Note readNote(BinaryReader& reader, JournalIDs& ids)
+	{
+		Note note((NoteType)reader.readInt32());
+		note.ID = ids.notes.get(reader.readInt32());
+		note.parentID = ids.notes.get(reader.readInt32());
+		note.tick = reader.readInt32();
+		note.lane = reader.readSingle();
+		note.width = reader.readSingle();
+		note.critical = reader.readInt32();
+		note.friction = reader.readInt32();
+		note.flick = (FlickType)reader.readInt32();
+		note.layer = reader.readInt32();
+		return note;
+	}
+
+	static void writeHoldStep(const HoldStep& step, BinaryWriter& writer)
+	{
+		writer.writeInt32(step.ID);
+		writer.writeInt32((int)step.type);
+		writer.writeInt32((int)step.ease);
+	}
+
+	static HoldStep readHoldStep(BinaryReader& reader, JournalIDs& ids)
+	{
+		HoldStep step;
+		step.ID = ids.notes.get(reader.readInt32());
+		step.type = (HoldStepType)reader.readInt32();
+		step.ease = (EaseType)reader.readInt32();
+		return step;
+	}
+
+	static void writeHold(const HoldNote& hold, BinaryWriter& writer)
+	{
+		writeHoldStep(hold.start, writer);
+		writer.writeInt32(hold.steps.size());
+		for (const auto& step : hold.steps)
+			writeHoldStep(step, writer);
+
+		writer.writeInt32(hold.end);
+		writer.writeInt32((int)hold.startType);
+		writer.writeInt32((int)hold.endType);
+		writer.writeInt32((int)hold.fadeType);
+		writer.writeInt32((int)hold.guideColor);
+	}
+
+	static HoldNote readHold(BinaryReader& reader, JournalIDs& ids)
+	{
+		HoldNote hold;
+		hold.start = readHoldStep(reader, ids);
+		size_t stepCount = readCount(reader);
+		hold.steps.reserve(stepCount);
+		for (size_t i = 0; i < stepCount; ++i)
+			hold.steps.push_back(readHoldStep(reader, ids));
+
+		hold.end = ids.notes.get(reader.readInt32());
+		hold.startType = (HoldNoteType)reader.readInt32();
+		hold.endType = (HoldNoteType)reader.readInt32();
+		hold.fadeType = (FadeType)reader.readInt32();
+		hold.guideColor = (GuideColor)reader.readInt32();
+		return hold;
+	}
+
+	static void writeHiSpeed(const HiSpeedChange& hiSpeed, BinaryWriter& writer)
+	{
+		writer.writeInt32(hiSpeed.ID);
+		writer.writeInt32(hiSpeed.tick);
+		writer.writeSingle(hiSpeed.speed);
+		writer.writeInt32(hiSpeed.layer);
+	}
+
+	static HiSpeedChange readHiSpeed(BinaryReader& reader, JournalIDs& ids)
+	{
+		HiSpeedChange hiSpeed{};
+		hiSpeed.ID = ids.hiSpeeds.get(reader.readInt32());
+		hiSpeed.tick = reader.readInt32();
+		hiSpeed.speed = reader.readSingle();
+		hiSpeed.layer = reader.readInt32();
+		return hiSpeed;
+	}
+
+	static void writeTimeSignature(const TimeSignature& timeSignature, BinaryWriter& writer)
+	{
+		writer.writeInt32(timeSignature.measure);
+		writer.writeInt32(timeSignature.numerator);
+		writer.writeInt32(timeSignature.denominator);
+	}
+
+	static TimeSignature readTimeSignature(BinaryReader& reader, JournalIDs&)
+	{
+		TimeSignature timeSignature{};
+		timeSignature.measure = reader.readInt32();
+		timeSignature.numerator = reader.readInt32();
+		timeSignature.denominator = reader.readInt32();
+		return timeSignature;
+	}
+
+	static void writeTempo(const Tempo& tempo, BinaryWriter& writer)
+	{
+		writer.writeInt32(tempo.tick);
+		writer.writeSingle(tempo.bpm);
+	}
+
+	static Tempo readTempo(BinaryReader& reader, JournalIDs&)
+	{
+		int tick = reader.readInt32();
+		float bpm = reader.readSingle();
+		return Tempo(tick, bpm);
+	}
+
+	static void writeSkill(const SkillTrigger& skill, BinaryWriter& writer)
+	{
+		writer.writeInt32(skill.ID);
+		writer.writeInt32(skill.tick);
+	}
+
+	static SkillTrigger readSkill(BinaryReader& reader, JournalIDs& ids)
+	{
+		SkillTrigger skill{};
+		skill.ID = ids.skills.get(reader.readInt32());
+		skill.tick = reader.readInt32();
+		return skill;
+	}
+
+	static void writeFever(const Fever& fever, BinaryWriter& writer)
+	{
+		writer.writeInt32(fever.startTick);
+		writer.writeInt32(fever.endTick);
+	}
+
+	static Fever readFever(BinaryReader& reader, JournalIDs&)
+	{
+		Fever fever{};
+		fever.startTick = reader.readInt32();
+		fever.endTick = reader.readInt32();
+		return fever;
+	}
+
+	static void writeMetadata(const ScoreMetadata& metadata, BinaryWriter& writer)
+	{
+		writer.writeString(metadata.title);
+		writer.writeString(metadata.artist);
+		writer.writeString(metadata.author);
+		writer.writeString(metadata.musicFile);
+		writer.writeString(metadata.jacketFile);
+		writer.writeSingle(metadata.musicOffset);
+		writer.writeInt32(metadata.laneExtension);
+	}
+
+	static ScoreMetadata readMetadata(BinaryReader& reader, JournalIDs&)
+	{
+		ScoreMetadata metadata{};
+		metadata.title = reader.readString();
+		metadata.artist = reader.readString();
+		metadata.author = reader.readString();
+		metadata.musicFile = reader.readString();
+		metadata.jacketFile = reader.readString();
+		metadata.musicOffset = reader.readSingle();
+		metadata.laneExtension = reader.readInt32();
+		return metadata;
+	}
+
+	static void writeLayer(const Layer& layer, BinaryWriter& writer)
+	{
+		writer.writeString(layer.name);
+		writer.writeInt32(layer.hidden);
+	}
+
+	static Layer readLayer(BinaryReader& reader, JournalIDs&)
+	{
+		Layer layer{};
+		layer.name = reader.readString();
+		layer.hidden = reader.readInt32();
+		return layer;
+	}
+
+	static void writeWaypoint(const Waypoint& waypoint, BinaryWriter& writer)
+	{
+		writer.writeString(waypoint.name);
+		writer.writeInt32(waypoint.tick);
+	}
+
+	static Waypoint readWaypoint(BinaryReader& reader, JournalIDs&)
+	{
+		Waypoint waypoint{};
+		waypoint.name = reader.readString();
+		waypoint.tick = reader.readInt32();
+		return waypoint;
+	}
+
+	template <typename T, typename WriteValue>
+	static void writeVector(const std::vector<T>& values, BinaryWriter& writer, WriteValue write)
+	{
+		writer.writeInt32(values.size());
+		for (const T& value : values)
+			write(value, writer);
+	}
+
+	template <typename T, typename ReadValue>
+	static std::vector<T> readVector(BinaryReader& reader, JournalIDs& ids, ReadValue read)
+	{
+		std::vector<T> values;
+		size_t count = readCount(reader);
+		values.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+			values.push_back(read(reader, ids));
+
+		return values;
+	}
+
+	template <typename Value, typename WriteValue>
+	static void writeMapDelta(const MapDelta<int, Value>& delta, BinaryWriter& writer,
+	                          WriteValue write)
+	{
+		writer.writeInt32(delta.entries.size());
+		for (const auto& entry : delta.entries)
+		{
+			writer.writeInt32(entry.key);
+			writer.writeInt32(entry.existsAfter);
+			if (entry.existsAfter)
+				write(entry.after, writer);
+		}
+	}
+
+	template <typename Value, typename ReadValue>
+	static void readMapDelta(MapDelta<int, Value>& delta, BinaryReader& reader, JournalIDs& ids,
+	                         JournalIDMap* keys, ReadValue read)
+	{
+		size_t count = readCount(reader);
+		delta.entries.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			int key = reader.readInt32();
+			if (keys)
+				key = keys->get(key);
+
+			bool exists = reader.readInt32();
+			Value after = exists ? read(reader, ids) : Value{};
+			delta.entries.push_back({ key, true, exists, Value{}, after });
+		}
+	}
+
+	template <typename T, typename WriteValue>
+	static void writeValueDelta(const ValueDelta<T>& delta, BinaryWriter& writer, WriteValue write)
+	{
+		writer.writeInt32(delta.changed);
+		if (delta.changed)
+			write(delta.after, writer);
+	}
+
+	template <typename T, typename ReadValue>
+	static void readValueDelta(ValueDelta<T>& delta, BinaryReader& reader, JournalIDs& ids,
+	                           ReadValue read)
+	{
+		delta.changed = reader.readInt32();
+		if (delta.changed)
+			delta.after = read(reader, ids);
+	}
+
+	static void writeDelta(const ScoreDelta& delta, BinaryWriter& writer)
+	{
+		writeMapDelta(delta.notes, writer, writeNote);
+		writeMapDelta(delta.holdNotes, writer, writeHold);
+		writeMapDelta(delta.hiSpeedChanges, writer, writeHiSpeed);
+		writeMapDelta(delta.timeSignatures, writer, writeTimeSignature);
+		writeValueDelta(delta.tempoChanges, writer, [](const std::vector<Tempo>& tempos,
+		                                               BinaryWriter& writer)
+		                { writeVector(tempos, writer, writeTempo); });
+		writeValueDelta(delta.skills, writer, [](const std::vector<SkillTrigger>& skills,
+		                                         BinaryWriter& writer)
+		                { writeVector(skills, writer, writeSkill); });
+		writeValueDelta(delta.fever, writer, writeFever);
+		writeValueDelta(delta.metadata, writer, writeMetadata);
+		writeValueDelta(delta.layers, writer, [](const std::vector<Layer>& layers,
+		                                         BinaryWriter& writer)
+		                { writeVector(layers, writer, writeLayer); });
+		writeValueDelta(delta.waypoints, writer, [](const std::vector<Waypoint>& waypoints,
+		                                            BinaryWriter& writer)
+		                { writeVector(waypoints, writer, writeWaypoint); });
+	}
+
+	static ScoreDelta readDelta(BinaryReader& reader, JournalIDs& ids)
+	{
+		ScoreDelta delta;
+		readMapDelta(delta.notes, reader, ids, &ids.notes, readNote);
+		readMapDelta(delta.holdNotes, reader, ids, &ids.notes, readHold);
+		readMapDelta(delta.hiSpeedChanges, reader, ids, &ids.hiSpeeds, readHiSpeed);
+		readMapDelta(delta.timeSignatures, reader, ids, nullptr, readTimeSignature);
+		readValueDelta(delta.tempoChanges, reader, ids, [](BinaryReader& reader, JournalIDs& ids)
+		               { return readVector<Tempo>(reader, ids, readTempo); });
+		readValueDelta(delta.skills, reader, ids, [](BinaryReader& reader, JournalIDs& ids)
+		               { return readVector<SkillTrigger>(reader, ids, readSkill); });
+		readValueDelta(delta.fever, reader, ids, readFever);
+		readValueDelta(delta.metadata, reader, ids, readMetadata);
+		readValueDelta(delta.layers, reader, ids, [](BinaryReader& reader, JournalIDs& ids)
+		               { return readVector<Layer>(reader, ids, readLayer); });
+		readValueDelta(delta.waypoints, reader, ids, [](BinaryReader& reader, JournalIDs& ids)
+		               { return readVector<Waypoint>(reader, ids, readWaypoint); });
+		return delta;
+	}
+
+	// Size and FNV-1a hash of the base file's contents, which identify the file the journal was
+	// started from even if a later save rewrites it with the same size
+	struct BaseFileStamp
+	{
+		uint32_t size{};
+		uint64_t hash{ 14695981039346656037ull };
+	};
+
+	static BaseFileStamp getBaseFileStamp(const std::string& baseFilename)
+	{
+		BaseFileStamp stamp;
+		std::unique_ptr<FILE, decltype(&fclose)> file(File::openStream(baseFilename, "rb"),
+		                                              &fclose);
+		if (!file)
+			return stamp;
+
+		uint8_t chunk[16384];
+		size_t read;
+		while ((read = fread(chunk, 1, sizeof(chunk), file.get())) > 0)
+		{
+			stamp.size += read;
+			for (size_t i = 0; i < read; ++i)
+				stamp.hash = (stamp.hash ^ chunk[i]) * 1099511628211ull;
+		}
+
+		return stamp;
+	}
+
+	std::string getScoreJournalFilename(const std::string& baseFilename)
+	{
+		return File::getFilepath(baseFilename) +
+		       File::getFilenameWithoutExtension(baseFilename) + MMWS_JOURNAL_EXTENSION;
+	}
+
+	void createScoreJournal(const Score& score, const std::string& baseFilename)
+	{
+		std::vector<int> noteIDs, hiSpeedIDs;
+		getSerializationOrder(score, noteIDs, hiSpeedIDs);
+
+		BinaryWriter writer(getScoreJournalFilename(baseFilename));
+		if (!writer.isStreamValid())
+			throw std::runtime_error("Failed to open the journal for writing.");
+
+		writer.writeString(JOURNAL_SIGNATURE);
+		writer.writeInt16(JOURNAL_VERSION);
+		const BaseFileStamp stamp = getBaseFileStamp(baseFilename);
+		writer.writeInt32(stamp.size);
+		writer.writeInt32(static_cast<uint32_t>(stamp.hash));
+		writer.writeInt32(static_cast<uint32_t>(stamp.hash >> 32));
+
+		writer.writeInt32(noteIDs.size());
+		for (int id : noteIDs)
+			writer.writeInt32(id);
+
+		writer.writeInt32(hiSpeedIDs.size());
+		for (int id : hiSpeedIDs)
+			writer.writeInt32(id);
+
+		writer.writeInt32(score.skills.size());
+		for (const auto& skill : score.skills)
+			writer.writeInt32(skill.ID);
+
+		if (!writer.close())
+			throw std::runtime_error("Failed to write the journal.");
+	}
+
+	void appendScoreJournal(const ScoreDelta& delta, const std::string& baseFilename)
+	{
+		// Records are prefixed with their size so a partially written one can be detected
+		BinaryWriter record;
+		record.writeNull(sizeof(uint32_t));
+		writeDelta(delta, record);
+		record.writeInt32At(0, record.getFileSize() - sizeof(uint32_t));
+
+		std::string filename = getScoreJournalFilename(baseFilename);
+		if (!File::exists(filename))
+			throw std::runtime_error("The journal does not exist.");
+
+		FILE* journal = File::openStream(filename, "ab");
+		if (!journal)
+			throw std::runtime_error("Failed to open the journal for writing.");
+
+		const std::vector<uint8_t>& bytes = record.getBuffer();
+		const bool written = fwrite(bytes.data(), 1, bytes.size(), journal) == bytes.size();
+		if (fclose(journal) != 0 || !written)
+			throw std::runtime_error("Failed to append to the journal.");
+	}
+
+	int replayScoreJournal(Score& score, const std::string& baseFilename)
+	{
+		std::string filename = getScoreJournalFilename(baseFilename);
+		if (!File::exists(filename))
+			return 0;
+
+		BinaryReader reader(filename);
+		if (!reader.isStreamValid() || reader.readString() != JOURNAL_SIGNATURE ||
+		    reader.readUInt16() != JOURNAL_VERSION)
+			return 0;
+
+		// The base file was replaced after the journal was started
+		const BaseFileStamp stamp = getBaseFileStamp(baseFilename);
+		const uint32_t size = reader.readUInt32();
+		const uint64_t hashLow = reader.readUInt32();
+		const uint64_t hashHigh = reader.readUInt32();
+		if (size != stamp.size || (hashLow | hashHigh << 32) != stamp.hash)
+			return 0;
+
+		JournalIDs ids;
+
+		// deserializeScore assigns consecutive note IDs in the order the notes were written
+		size_t noteCount = readCount(reader);
+		if (noteCount != score.notes.size())
+			return 0;
+
+		int firstNoteID = INT_MAX;
+		for (const auto& [id, _] : score.notes)
+			firstNoteID = std::min(firstNoteID, id);
+
+		for (size_t i = 0; i < noteCount; ++i)
+			ids.notes.set(reader.readInt32(), firstNoteID + i);
+
+		// A loaded score may start with an extra default hi-speed change with the lowest ID
+		size_t hiSpeedCount = readCount(reader);
+		std::vector<int> hiSpeedIDs;
+		for (const auto& [id, _] : score.hiSpeedChanges)
+			hiSpeedIDs.push_back(id);
+
+		if (hiSpeedIDs.size() < hiSpeedCount)
+			return 0;
+
+		std::sort(hiSpeedIDs.begin(), hiSpeedIDs.end());
+		const size_t hiSpeedOffset = hiSpeedIDs.size() - hiSpeedCount;
+		for (size_t i = 0; i < hiSpeedCount; ++i)
+			ids.hiSpeeds.set(reader.readInt32(), hiSpeedIDs[hiSpeedOffset + i]);
+
+		// Skills are written in order and get new IDs in the same order when loaded
+		size_t skillCount = readCount(reader);
+		if (skillCount != score.skills.size())
+			return 0;
+
+		for (size_t i = 0; i < skillCount; ++i)
+			ids.skills.set(reader.readInt32(), score.skills[i].ID);
+
+		int recordCount = 0;
+		while (reader.getStreamPosition() + sizeof(uint32_t) <= reader.getFileSize())
+		{
+			size_t length = reader.readUInt32();
+			size_t end = reader.getStreamPosition() + length;
+			if (end > reader.getFileSize())
+				break;
+
+			ScoreDelta delta = readDelta(reader, ids);
+			if (reader.getStreamPosition() != end)
+				break;
+
+			delta.applyForward(score);
+			++recordCount;
+		}
+
+		return recordCount;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "ScoreDelta.h"
+#include <string>
+
+namespace MikuMikuWorld
+{
+	/*
+	 * A journal is an append-only log of score deltas stored next to a MMWS base file.
+	 * It starts with the size and a hash of the base file and the IDs its notes and hi-speed changes
+	 * had when it was written, followed by one length-prefixed record per appended delta.
+	 * Only the forward half of each delta is stored, which is all that replaying needs.
+	 */
+
+	// Returns the journal file that belongs to the MMWS file
+	std::string getScoreJournalFilename(const std::string& baseFilename);
+
+	/**
+	 * @brief Starts an empty journal for a base file that was just written from `score`
+	 * @throw `std::runtime_error` if the journal could not be written
+	 */
+	void createScoreJournal(const Score& score, const std::string& baseFilename);
+
+	/**
+	 * @brief Appends a delta to the journal of the base file in a single write
+	 * @throw `std::runtime_error` if the journal could not be opened or fully written, later
+	 *        records would be appended after a torn one so a new journal has to be started
+	 */
+	void appendScoreJournal(const ScoreDelta& delta, const std::string& baseFilename);
+
+	/**
+	 * @brief Applies the journal of the base file to a score that was just loaded from it
+	 * @note The journal is ignored if it does not match the base file. A record cut short by an
+	 *       interrupted write ends the replay
+	 * @return The number of records applied
+	 */
+	int replayScoreJournal(Score& score, const std::string& baseFilename);
+}
@@ -1,4 +1,5 @@
 #include "ScoreStats.h"
+#include "NoteColumns.h"
 #include "Score.h"
 #include "Constants.h"
 #include <algorithm>
@@ -17,37 +18,35 @@ namespace MikuMikuWorld
 
 	void ScoreStats::resetCombo() { combo = 0; }
 
-	void ScoreStats::calculateStats(const Score& score)
+	void ScoreStats::calculateStats(const Score& score, const NoteColumns& columns)
 	{
-		taps = std::count_if(score.notes.begin(), score.notes.end(),
-		                     [](const auto& n)
-		                     {
-			                     const Note& note = n.second;
-			                     return note.getType() == NoteType::Tap && !note.isFlick() &&
-			                            !note.friction;
-		                     });
-
-		holds = std::count_if(score.notes.begin(), score.notes.end(),
-		                      [](const auto& n) { return n.second.getType() == NoteType::Hold; });
-
-		steps =
-		    std::count_if(score.notes.begin(), score.notes.end(),
-		                  [](const auto& n) { return n.second.getType() == NoteType::HoldMid; });
-
-		flicks = std::count_if(score.notes.begin(), score.notes.end(),
-		                       [](const auto& n) { return n.second.isFlick(); });
+		resetCounts();
 
-		traces = std::count_if(score.notes.begin(), score.notes.end(),
-		                       [](const auto& n) { return n.second.friction; });
+		const std::vector<NoteType>& noteTypes = columns.getTypes();
+		const std::vector<uint8_t>& noteFlags = columns.getFlags();
+		const std::vector<FlickType>& noteFlicks = columns.getFlicks();
+		for (size_t i = 0; i < columns.size(); ++i)
+		{
+			const NoteType type = noteTypes[i];
+			const bool friction = noteFlags[i] & NoteColumns::FLAG_FRICTION;
+			const bool flick = noteFlicks[i] != FlickType::None && type != NoteType::Hold &&
+			                   type != NoteType::HoldMid;
+
+			taps += type == NoteType::Tap && !flick && !friction;
+			holds += type == NoteType::Hold;
+			steps += type == NoteType::HoldMid;
+			flicks += flick;
+			traces += friction;
+		}
 
-		total = score.notes.size();
-		calculateCombo(score);
+		total = columns.size();
+		calculateCombo(score, columns);
 	}
 
-	void ScoreStats::calculateCombo(const Score& score)
+	void ScoreStats::calculateCombo(const Score& score, const NoteColumns& columns)
 	{
 		resetCombo();
-		combo = score.notes.size();
+		combo = columns.size();
 
 		constexpr int halfBeat = TICKS_PER_BEAT / 2;
 		for (const auto& [id, hold] : score.holdNotes)
@@ -70,8 +69,8 @@ namespace MikuMikuWorld
 			                       [](const HoldStep& step)
 			                       { return step.type == HoldStepType::Hidden; });
 
-			int startTick = score.notes.at(id).tick;
-			int endTick = score.notes.at(hold.end).tick;
+			int startTick = columns.at(id).getTick();
+			int endTick = columns.at(hold.end).getTick();
 			int eighthTick = startTick;
 
 			eighthTick += halfBeat;
@@ -3,6 +3,7 @@
 namespace MikuMikuWorld
 {
 	struct Score;
+	class NoteColumns;
 
 	class ScoreStats
 	{
@@ -15,8 +16,9 @@ namespace MikuMikuWorld
 	  public:
 		ScoreStats();
 
-		void calculateStats(const Score& score);
-		void calculateCombo(const Score& score);
+		// `columns` must mirror the notes of `score`
+		void calculateStats(const Score& score, const NoteColumns& columns);
+		void calculateCombo(const Score& score, const NoteColumns& columns);
 		void reset();
 
 		int getTaps() const { return taps; }
@@ -1,5 +1,6 @@
 #include "Sonolus_json.h"
 
+#include "File.h"
 #include "IO.h"
 #include "Math.h"
 #include "Constants.h"
@@ -11,6 +12,7 @@
 #include <unordered_map>
 #include <stdexcept>
 #include <optional>
+#include <memory>
 
 using namespace MikuMikuWorld;
 using namespace Sonolus_json;
@@ -128,7 +130,11 @@ Score Sonolus_json::load_file(const std::string& file_name) {
 	Score ret;
 	ret.tempoChanges.pop_back();
 
-	json js = json::parse(_wfopen(IO::mbToWideStr(file_name).c_str(), L"r"));
+	std::unique_ptr<FILE, decltype(&fclose)> file(IO::File::openStream(file_name, "r"), &fclose);
+	if (!file)
+		throw std::runtime_error("Failed to open " + file_name);
+
+	json js = json::parse(file.get());
 
 	// Extract music offset
 	assert(js["bgmOffset"].is_number());
@@ -4,6 +4,7 @@
 #include "File.h"
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 #include <unordered_set>
 
 using namespace IO;
@@ -112,7 +113,7 @@ namespace MikuMikuWorld
 		           note.hiSpeedGroup);
 	}
 
-	std::vector<std::string> SusExporter::getNoteLines(int baseMeasure)
+	std::vector<std::string> SusExporter::getNoteLines(int& baseMeasure)
 	{
 		std::vector<std::string> lines;
 
@@ -318,7 +319,7 @@ namespace MikuMikuWorld
 			    bpmIdentifiers.size(), maxBpmIdentifiers);
 			printf("%s", errorMessage.c_str());
 
-			throw std::exception(errorMessage.c_str());
+			throw std::runtime_error(errorMessage);
 		}
 
 		// Group bpms by measure
@@ -421,11 +422,19 @@ namespace MikuMikuWorld
 		std::vector<std::string> guideLines = getNoteLines(baseMeasure);
 		lines.insert(lines.end(), guideLines.begin(), guideLines.end());
 
-		std::wstring wFilename = mbToWideStr(filename);
-		File susfile(wFilename, L"w");
+		FILE* susfile = File::openStream(filename, "w");
+		if (!susfile)
+			throw std::runtime_error("Failed to open the file for writing.");
 
-		susfile.writeAllLines(lines);
-		susfile.flush();
-		susfile.close();
+		for (const auto& line : lines)
+		{
+			fwrite(line.data(), 1, line.size(), susfile);
+			fputc('\n', susfile);
+		}
+
+		// Write errors are sticky on the stream and closing flushes what is still buffered
+		const bool written = !ferror(susfile);
+		if (fclose(susfile) != 0 || !written)
+			throw std::runtime_error("Failed to write the file.");
 	}
 }
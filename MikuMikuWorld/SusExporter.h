@@ -60,7 +60,7 @@ namespace MikuMikuWorld
 		int getMeasureFromTicks(int ticks);
 		int getTicksFromMeasure(int measure);
 		void appendSlideData(const SUSNoteStream& slides, const std::string& infoPrefix);
-		std::vector<std::string> getNoteLines(int baseMeasure);
+		std::vector<std::string> getNoteLines(int& baseMeasure);
 
 	  public:
 		SusExporter();
@@ -68,6 +68,7 @@ namespace MikuMikuWorld
 		void appendData(int tick, std::string info, std::string data, std::string hiSpeedGroup);
 		void appendNoteData(const SUSNote& note, const std::string infoPrefix,
 		                    const std::string channel);
+		// Throws `std::runtime_error` if the file could not be opened or written
 		void dump(const SUS& sus, const std::string& filename, std::string comment = "");
 	};
 }
@@ -1,112 +1,164 @@
 #include "SusParser.h"
 #include "File.h"
 #include "IO.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
 
 using namespace IO;
 
 namespace MikuMikuWorld
 {
-	SusParser::SusParser() : ticksPerBeat{ 480 }, measureOffset{ 0 }, waveOffset{ 0 } {}
+	static std::string_view trimView(std::string_view str)
+	{
+		const size_t start = str.find_first_not_of(" \r");
+		if (start == std::string_view::npos)
+			return {};
+
+		return str.substr(start, str.find_last_not_of(" \r") - start + 1);
+	}
+
+	// Copies the value to a terminated buffer to parse it the same way as atoi and atof
+	static int toInt(std::string_view str)
+	{
+		char buffer[32]{};
+		std::copy_n(str.data(), std::min(str.size(), sizeof(buffer) - 1), buffer);
+		return atoi(buffer);
+	}
+
+	static float toFloat(std::string_view str)
+	{
+		char buffer[64]{};
+		std::copy_n(str.data(), std::min(str.size(), sizeof(buffer) - 1), buffer);
+		return (float)atof(buffer);
+	}
+
+	static int fromBase36(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'a' && c <= 'z')
+			return c - 'a' + 10;
+		if (c >= 'A' && c <= 'Z')
+			return c - 'A' + 10;
+
+		throw std::invalid_argument("Invalid SUS note data: " + std::string(1, c));
+	}
+
+	static std::string readAllText(const std::string& filename)
+	{
+		std::unique_ptr<FILE, decltype(&fclose)> file(File::openStream(filename, "rb"), &fclose);
+		if (!file)
+			throw std::runtime_error("Failed to open the file for reading.");
+
+		fseek(file.get(), 0, SEEK_END);
+		const long size = ftell(file.get());
+		fseek(file.get(), 0, SEEK_SET);
+
+		std::string text(std::max(size, 0l), '\0');
+		text.resize(fread(text.data(), sizeof(char), text.size(), file.get()));
+		return text;
+	}
+
+	SusParser::SusParser()
+	    : ticksPerBeat{ 480 }, measureOffset{ 0 }, laneOffset{ 0 }, sideLane{ false },
+	      waveOffset{ 0 }
+	{
+	}
 
-	bool SusParser::isCommand(const std::string& line)
+	bool SusParser::isCommand(std::string_view line) const
 	{
 		if (isDigit(line.substr(1, 1)))
 			return false;
 
 		// Test for text value commands
-		if (line.find_first_of('"') != std::string::npos)
+		if (line.find_first_of('"') != std::string_view::npos)
 		{
-			std::vector<std::string> lineSplit = split(line, " ");
-			if (lineSplit.size() < 2)
+			const size_t keyEnd = line.find_first_of(' ');
+			if (keyEnd == std::string_view::npos)
 				return false;
 
-			if (lineSplit[0].find_first_of(':') != std::string::npos)
+			if (line.substr(0, keyEnd).find_first_of(':') != std::string_view::npos)
 				return false;
 
-			int firstQuote = line.find_first_of('"');
-			int lastQuote = line.find_last_of('"');
-			return firstQuote != lastQuote && lastQuote != std::string::npos;
+			return line.find_first_of('"') != line.find_last_of('"');
 		}
 
-		return line.find_first_of(':') == std::string::npos;
+		return line.find_first_of(':') == std::string_view::npos;
 	}
 
-	int SusParser::toTicks(int measure, int i, int total)
+	SusParser::MeasureTicks SusParser::getMeasureTicks(int measure) const
 	{
-		int bIndex = 0;
-		int accBarTicks = 0;
-		for (int i = 0; i < bars.size(); ++i)
-		{
-			if (bars[i].measure > measure)
-				break;
+		// Measures before the first bar are measured with the first bar's length
+		auto next = std::upper_bound(bars.begin(), bars.end(), measure,
+		                             [](int measure, const Bar& bar) { return measure < bar.measure; });
 
-			bIndex = i;
-			accBarTicks += bars[i].ticks;
-		}
+		const Bar& bar = next == bars.begin() ? bars.front() : *std::prev(next);
+		const int barTicks = next == bars.begin() ? 0 : bar.ticks;
+		return { barTicks + (measure - bar.measure) * bar.ticksPerMeasure, bar.ticksPerMeasure };
+	}
 
-		return accBarTicks + ((measure - bars[bIndex].measure) * bars[bIndex].ticksPerMeasure) +
-		       ((i * bars[bIndex].ticksPerMeasure) / total);
+	int SusParser::toTicks(int measure, int i, int total) const
+	{
+		const MeasureTicks measureTicks = getMeasureTicks(measure);
+		return measureTicks.tick + (i * measureTicks.ticksPerMeasure) / total;
 	}
 
-	SUSNoteStream SusParser::toSlides(const std::vector<SUSNote>& stream)
+	SUSNoteStream SusParser::toSlides(std::vector<SUSNote> stream) const
 	{
-		std::vector<SUSNote> sortedStream = stream;
-		std::stable_sort(sortedStream.begin(), sortedStream.end(),
+		std::stable_sort(stream.begin(), stream.end(),
 		                 [](const SUSNote& n1, const SUSNote& n2) { return n1.tick < n2.tick; });
 
-		bool newSlide = true;
 		SUSNoteStream slides;
-		std::vector<SUSNote> currentSlides;
-		for (const auto& note : sortedStream)
+		std::vector<SUSNote> currentSlide;
+		for (SUSNote& note : stream)
 		{
-			if (newSlide)
-			{
-				currentSlides.clear();
-				newSlide = false;
-			}
-
-			currentSlides.push_back(note);
+			currentSlide.push_back(std::move(note));
 
 			// Found slide end
-			if (note.type == 2)
+			if (currentSlide.back().type == 2)
 			{
-				slides.push_back(currentSlides);
-				newSlide = true;
+				slides.push_back(std::move(currentSlide));
+				currentSlide.clear();
 			}
 		}
 
 		return slides;
 	}
 
-	std::vector<SUSNote> SusParser::toNotes(const std::string& header, const std::string& data,
-	                                        int measureBase)
+	void SusParser::toNotes(const SusLineData& line, std::vector<SUSNote>& notes) const
 	{
-		std::vector<SUSNote> notes;
-		int measure = measureBase + std::stoul(header.substr(0, 3).c_str(), nullptr, 10);
-		for (int i = 0; i < data.size(); i += 2)
+		const std::string_view header = line.header;
+		const std::string_view data = line.data;
+		const int measure = line.measureOffset + toInt(header.substr(0, 3));
+		const int lane = fromBase36(header[4]) + laneOffset;
+		const MeasureTicks measureTicks = getMeasureTicks(measure);
+		const int total = data.size();
+
+		for (int i = 0; i < total; i += 2)
 		{
 			// no data
-			if (data.substr(i, 2) == "00")
+			if (data[i] == '0' && i + 1 < total && data[i + 1] == '0')
 				continue;
 
-			notes.push_back(SUSNote{ toTicks(measure, i, data.size()),
-			                         (int)std::stoul(header.substr(4, 1), nullptr, 36) + laneOffset,
-			                         (int)std::stoul(data.substr(i + 1, 1), nullptr, 36),
-			                         (int)std::stoul(data.substr(i, 1), nullptr, 36),
-			                         currentHiSpeedGroup });
-		}
+			if (i + 1 == total)
+				throw std::invalid_argument("Incomplete SUS note data");
 
-		return notes;
+			notes.push_back(SUSNote{
+			    measureTicks.tick + (i * measureTicks.ticksPerMeasure) / total, lane,
+			    fromBase36(data[i + 1]), fromBase36(data[i]), std::string(line.hiSpeedGroup) });
+		}
 	}
 
-	void SusParser::processCommand(std::string& line)
+	void SusParser::processCommand(std::string_view line)
 	{
-		int keyPos = line.find_first_of(' ');
-		if (keyPos == std::string::npos)
+		size_t keyPos = line.find_first_of(' ');
+		if (keyPos == std::string_view::npos)
 			return;
 
-		std::string key = line.substr(1, keyPos - 1);
-		std::string value = line.substr(keyPos + 1);
+		std::string key(line.substr(1, keyPos - 1));
+		std::string value(line.substr(keyPos + 1));
 
 		std::transform(key.begin(), key.end(), key.begin(), ::toupper);
 
@@ -142,16 +194,13 @@ namespace MikuMikuWorld
 
 	SUS SusParser::parse(const std::string& filename)
 	{
-		std::wstring wFilename = mbToWideStr(filename);
-
-		File susFile(wFilename, L"r");
-		auto lines = susFile.readAllLines();
-		susFile.close();
+		// Lines are only referenced by views into the file's text until the notes are created
+		const std::string text = readAllText(filename);
+		std::string_view remaining = text;
+		if (remaining.substr(0, 3) == "\xEF\xBB\xBF")
+			remaining.remove_prefix(3);
 
-		currentHiSpeedGroup = "00";
-
-		std::unordered_map<int, int> measureOffsets;
-		std::unordered_map<int, std::string> hiSpeedGroupChanges;
+		std::string_view currentHiSpeedGroup = "00";
 
 		std::vector<SusLineData> noteLines;
 		std::vector<SusLineData> bpmLines;
@@ -160,67 +209,64 @@ namespace MikuMikuWorld
 		bpmDefinitions.clear();
 		measureOffset = 0;
 
-		for (int i = 0; i < lines.size(); ++i)
+		for (int i = 0; !remaining.empty(); ++i)
 		{
-			std::string line = trim(lines[i]);
-			if (!startsWith(line, "#"))
+			const size_t lineEnd = remaining.find_first_of('\n');
+			std::string_view line = trimView(remaining.substr(0, lineEnd));
+			remaining.remove_prefix(lineEnd == std::string_view::npos ? remaining.size() : lineEnd + 1);
+
+			if (line.empty() || line[0] != '#')
 				continue;
 
 			if (line.substr(0, 9) == "#HISPEED ")
 			{
-				int keyPos = line.find_first_of(' ');
-				if (keyPos == std::string::npos)
-					continue;
-
-				std::string value = line.substr(keyPos + 1);
-				hiSpeedGroupChanges.insert_or_assign((int)noteLines.size(), trim(value));
+				currentHiSpeedGroup = trimView(line.substr(9));
 				continue;
 			}
-			else if (line.substr(0, 12) == "#MEASUREBS ")
+			else if (line.substr(0, 11) == "#MEASUREBS ")
 			{
-				int keyPos = line.find_first_of(' ');
-				if (keyPos == std::string::npos)
-					continue;
-
-				std::string value = line.substr(keyPos + 1);
-				measureOffsets.insert_or_assign((int)noteLines.size(), atoi(value.c_str()));
+				measureOffset = toInt(line.substr(11));
 				continue;
 			}
 			else if (isCommand(line))
 			{
 				processCommand(line);
+				continue;
 			}
-			else
-			{
-				auto l = split(line, ":");
-				if (l.size() < 2) // no ':' found
-					continue;
 
-				std::string header = trim(l[0]).substr(1);
-				std::string data = l.size() > 1 ? trim(l[1]) : "";
-
-				if (header.size() == 5 && header.substr(header.size() - 2) == "02" &&
-				    isDigit(header))
-				{
-					barLengths.push_back({ measureOffset + atoi(header.substr(0, 3).c_str()),
-					                       (float)atof((data.c_str())) });
-				}
-				else if (header.size() == 5 && startsWith(header, "BPM"))
-				{
-					bpmDefinitions[header.substr(3)] = atof(data.c_str());
-				}
-				else if (header.size() == 5 && header.substr(0, 3) == "TIL")
-				{
-					hiSpeedLines.push_back({ i, measureOffset, line });
-				}
-				else if (header.size() == 5 && header.substr(header.size() - 2, 2) == "08")
-				{
-					bpmLines.push_back({ i, measureOffset, line });
-				}
-				else if (header.size() == 5 || header.size() == 6)
-				{
-					noteLines.push_back({ i, measureOffset, line });
-				}
+			// A line without data after the colon has nothing to read
+			const size_t colon = line.find_first_of(':');
+			if (colon == std::string_view::npos || colon + 1 == line.size())
+				continue;
+
+			const std::string_view header = trimView(line.substr(0, colon)).substr(1);
+			const std::string_view data = line.substr(colon + 1);
+			const SusLineData lineData{
+				i, measureOffset, header,
+				trimView(data.substr(0, data.find_first_of(':'))), currentHiSpeedGroup
+			};
+
+			if (header.size() == 5 && endsWith(header, "02") && isDigit(header))
+			{
+				barLengths.push_back({ measureOffset + toInt(header.substr(0, 3)),
+				                       toFloat(lineData.data) });
+			}
+			else if (header.size() == 5 && startsWith(header, "BPM"))
+			{
+				bpmDefinitions[std::string(header.substr(3))] = toFloat(lineData.data);
+			}
+			else if (header.size() == 5 && startsWith(header, "TIL"))
+			{
+				// Hi-speed changes are separated by colons as well
+				hiSpeedLines.push_back({ i, measureOffset, header, data, currentHiSpeedGroup });
+			}
+			else if (header.size() == 5 && endsWith(header, "08"))
+			{
+				bpmLines.push_back(lineData);
+			}
+			else if (header.size() == 5 || header.size() == 6)
+			{
+				noteLines.push_back(lineData);
 			}
 		}
 
@@ -228,45 +274,43 @@ namespace MikuMikuWorld
 		if (!barLengths.size())
 			barLengths.push_back({ 0, 4.0f });
 
-		int ticks = 0;
 		bars.clear();
 		bars.reserve(barLengths.size());
-		for (int i = 0; i < barLengths.size(); ++i)
+		for (size_t i = 0; i < barLengths.size(); ++i)
 		{
 			int measure = barLengths[i].bar;
 			int ticksPerMeasure = barLengths[i].length * ticksPerBeat;
-			ticks = ticks + i == 0 ? 0
-			                       : (measure - barLengths[i - 1].bar) * barLengths[i - 1].length *
-			                             ticksPerBeat;
+			int ticks = i == 0 ? 0
+			                   : (measure - barLengths[i - 1].bar) * barLengths[i - 1].length *
+			                         ticksPerBeat;
 
 			bars.push_back(Bar{ measure, ticksPerMeasure, ticks });
 		}
 		std::sort(bars.begin(), bars.end(),
 		          [](const Bar& b1, const Bar& b2) { return b1.measure < b2.measure; });
 
+		// Accumulate the lengths of the previous bars so notes find their bar's tick in one lookup
+		for (size_t i = 1; i < bars.size(); ++i)
+			bars[i].ticks += bars[i - 1].ticks;
+
 		// Process BPM changes
 		std::vector<BPM> bpms;
-		for (auto& line : bpmLines)
+		for (const auto& line : bpmLines)
 		{
-			auto l = split(line.line, ":");
-			if (l.size() < 2) // no ':' found
-				continue;
-
-			std::string header = trim(l[0]).substr(1);
-			std::string data = l.size() > 1 ? trim(l[1]) : "";
-
-			for (int i = 0; i < data.size(); i += 2)
+			const std::string_view data = line.data;
+			const int measure = line.measureOffset + toInt(line.header.substr(0, 3));
+			for (size_t i = 0; i < data.size(); i += 2)
 			{
-				std::string subData = data.substr(i, 2);
+				std::string subData(data.substr(i, 2));
 				if (subData == "00")
 					continue;
 
-				int tick =
-				    toTicks(line.measureOffset + atoi(header.substr(0, 3).c_str()), i, data.size());
+				int tick = toTicks(measure, i, data.size());
 				float bpm = 120;
 
-				if (bpmDefinitions.find(subData) != bpmDefinitions.end())
-					bpm = bpmDefinitions[subData];
+				auto definition = bpmDefinitions.find(subData);
+				if (definition != bpmDefinitions.end())
+					bpm = definition->second;
 
 				bpms.push_back({ tick, bpm });
 			}
@@ -276,43 +320,43 @@ namespace MikuMikuWorld
 
 		// process hi-speed changes
 		std::vector<HiSpeedGroup> hiSpeedGroups;
-		for (auto& line : hiSpeedLines)
+		for (const auto& line : hiSpeedLines)
 		{
-			auto l = split(line.line, ":");
-			if (l.size() < 2) // no ':' found
-				continue;
-
-			std::string name = trim(l[0]).substr(4);
-			std::string lineData = line.line.substr(line.line.find_first_of(':') + 1);
-			int firstQuote = lineData.find_first_of('"') + 1;
-			int lastQuote = lineData.find_last_of('"');
-
-			HiSpeedGroup group;
-			group.name = name;
+			std::string_view lineData = line.data;
+			const size_t firstQuote = lineData.find_first_of('"');
+			const size_t lastQuote = lineData.find_last_of('"');
+			if (firstQuote != std::string_view::npos)
+			{
+				lineData = lastQuote > firstQuote
+				               ? lineData.substr(firstQuote + 1, lastQuote - firstQuote - 1)
+				               : lineData.substr(firstQuote + 1);
+			}
 
-			lineData = lineData.substr(firstQuote, lastQuote - firstQuote);
 			if (!lineData.size())
 				continue;
 
-			std::vector<std::string> speedChanges = split(lineData, ",");
-			for (const auto& change : speedChanges)
-			{
-				int measure = 0;
-				int tick = 0;
-				float speed = 1.0f;
-
-				int i1 = 0;
-				int i2 = 0;
+			HiSpeedGroup group;
+			group.name = line.header.substr(3);
 
-				i2 = change.find_first_of("'", i1);
-				measure = atoi(change.substr(i1, i2 - i1).c_str());
+			while (!lineData.empty())
+			{
+				const size_t changeEnd = lineData.find_first_of(',');
+				const std::string_view change = lineData.substr(0, changeEnd);
+				lineData.remove_prefix(changeEnd == std::string_view::npos ? lineData.size()
+				                                                           : changeEnd + 1);
+				if (change.empty())
+					continue;
 
-				i1 = ++i2;
-				i2 = change.find_first_of(":", i2);
-				tick = atoi(change.substr(i1, i2 - i1).c_str());
+				// <measure>'<tick>:<speed>
+				const size_t tickStart = change.find_first_of('\'');
+				const size_t speedStart = change.find_first_of(':');
+				if (tickStart == std::string_view::npos || speedStart == std::string_view::npos ||
+				    speedStart < tickStart)
+					continue;
 
-				i1 = ++i2;
-				speed = atof(change.substr(i1).c_str());
+				int measure = toInt(change.substr(0, tickStart));
+				int tick = toInt(change.substr(tickStart + 1, speedStart - tickStart - 1));
+				float speed = toFloat(change.substr(speedStart + 1));
 
 				int measureTicks = toTicks(measure, 0, 1);
 				group.hiSpeeds.push_back({ measureTicks + tick, speed });
@@ -320,7 +364,7 @@ namespace MikuMikuWorld
 			std::stable_sort(group.hiSpeeds.begin(), group.hiSpeeds.end(),
 			                 [](const HiSpeed& a, const HiSpeed& b) { return a.tick < b.tick; });
 
-			hiSpeedGroups.push_back(group);
+			hiSpeedGroups.push_back(std::move(group));
 		}
 
 		// Process notes
@@ -328,60 +372,39 @@ namespace MikuMikuWorld
 		std::vector<SUSNote> directionals;
 		std::unordered_map<int, std::vector<SUSNote>> slideStreams;
 		std::unordered_map<int, std::vector<SUSNote>> guideStreams;
-		for (int i = 0; i < noteLines.size(); i++)
+		for (const auto& line : noteLines)
 		{
-			if (measureOffsets.find(i) != measureOffsets.end())
-				measureOffset = measureOffsets[i];
-			if (hiSpeedGroupChanges.find(i) != hiSpeedGroupChanges.end())
-				currentHiSpeedGroup = hiSpeedGroupChanges[i];
-			auto line = noteLines[i];
-			auto l = split(line.line, ":");
-			if (l.size() < 2) // no ':' found
-				continue;
-
-			std::string header = trim(l[0]).substr(1);
-			std::string data = l.size() > 1 ? trim(l[1]) : "";
-
+			const std::string_view header = line.header;
 			if (header.size() == 5 && header[3] == '1')
 			{
-				std::vector<SUSNote> appendNotes = toNotes(header, data, line.measureOffset);
-				taps.insert(taps.end(), appendNotes.begin(), appendNotes.end());
+				toNotes(line, taps);
 			}
 			else if (header.size() == 6 && header[3] == '3')
 			{
-				int channel = std::stoul(header.substr(5, 1), nullptr, 36);
-
-				std::vector<SUSNote> appendNotes = toNotes(header, data, line.measureOffset);
-				slideStreams[channel].insert(slideStreams[channel].end(), appendNotes.begin(),
-				                             appendNotes.end());
+				toNotes(line, slideStreams[fromBase36(header[5])]);
 			}
 			else if (header.size() == 5 && header[3] == '5')
 			{
-				std::vector<SUSNote> appendNotes = toNotes(header, data, line.measureOffset);
-				directionals.insert(directionals.end(), appendNotes.begin(), appendNotes.end());
+				toNotes(line, directionals);
 			}
 			else if (header.size() == 6 && header[3] == '9')
 			{
-				int channel = std::stoul(header.substr(5, 1), nullptr, 36);
-
-				std::vector<SUSNote> appendNotes = toNotes(header, data, line.measureOffset);
-				guideStreams[channel].insert(guideStreams[channel].end(), appendNotes.begin(),
-				                             appendNotes.end());
+				toNotes(line, guideStreams[fromBase36(header[5])]);
 			}
 		}
 
 		SUSNoteStream slides;
 		for (auto& stream : slideStreams)
 		{
-			auto appendSlides = toSlides(stream.second);
-			slides.insert(slides.end(), appendSlides.begin(), appendSlides.end());
+			auto appendSlides = toSlides(std::move(stream.second));
+			std::move(appendSlides.begin(), appendSlides.end(), std::back_inserter(slides));
 		}
 
 		SUSNoteStream guides;
 		for (auto& stream : guideStreams)
 		{
-			auto appendGuides = toSlides(stream.second);
-			guides.insert(guides.end(), appendGuides.begin(), appendGuides.end());
+			auto appendGuides = toSlides(std::move(stream.second));
+			std::move(appendGuides.begin(), appendGuides.end(), std::back_inserter(guides));
 		}
 
 		SUSMetadata metadata;
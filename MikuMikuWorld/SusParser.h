@@ -1,15 +1,18 @@
 #pragma once
 #include "SUS.h"
-#include <regex>
 #include <string>
+#include <string_view>
 
 namespace MikuMikuWorld
 {
+	// Views into the text of the parsed file
 	struct SusLineData
 	{
 		int lineIndex;
 		int measureOffset;
-		std::string line;
+		std::string_view header;
+		std::string_view data;
+		std::string_view hiSpeedGroup;
 	};
 
 	struct SusLineArgs
@@ -21,6 +24,12 @@ namespace MikuMikuWorld
 	class SusParser
 	{
 	  private:
+		struct MeasureTicks
+		{
+			int tick;
+			int ticksPerMeasure;
+		};
+
 		int ticksPerBeat;
 		int measureOffset;
 		int laneOffset;
@@ -30,20 +39,19 @@ namespace MikuMikuWorld
 		std::string artist;
 		std::string designer;
 		std::unordered_map<std::string, float> bpmDefinitions;
+		// Sorted by measure, `ticks` is the first tick of the bar
 		std::vector<Bar> bars;
 
-		std::string currentHiSpeedGroup;
-
-		bool isCommand(const std::string& line);
-		int toTicks(int measure, int i, int total);
-		SUSNoteStream toSlides(const std::vector<SUSNote>& stream);
-		std::vector<SUSNote> toNotes(const std::string& header, const std::string& data,
-		                             int measureBase);
+		bool isCommand(std::string_view line) const;
+		MeasureTicks getMeasureTicks(int measure) const;
+		int toTicks(int measure, int i, int total) const;
+		SUSNoteStream toSlides(std::vector<SUSNote> stream) const;
+		void toNotes(const SusLineData& line, std::vector<SUSNote>& notes) const;
 
 	  public:
 		SusParser();
 
 		SUS parse(const std::string& filename);
-		void processCommand(std::string& line);
+		void processCommand(std::string_view line);
 	};
 }
@@ -134,34 +134,228 @@ namespace MikuMikuWorld
 		return 0;
 	}
 
-	int findHighSpeedChange(int tick, const std::unordered_map<int, HiSpeedChange>& hiSpeeds,
-	                        int selectedLayer)
+	const Tempo& getTempoAt(int tick, const std::vector<Tempo>& tempos)
+	{
+		for (auto it = tempos.rbegin(); it != tempos.rend(); ++it)
+			if (it->tick <= tick)
+				return *it;
+
+		return tempos[0];
+	}
+
+	TempoMap::TempoMap(int _beatTicks) : beatTicks{ _beatTicks } {}
+
+	void TempoMap::rebuild(const std::vector<Tempo>& tempos)
 	{
-		std::vector<std::pair<int, HiSpeedChange>> currentLayersHiSpeeds;
-		for (auto& [i, h] : hiSpeeds)
+		segments.clear();
+		segments.reserve(tempos.size());
+
+		double seconds = 0;
+		for (const auto& tempo : tempos)
 		{
-			if (selectedLayer != -1 && h.layer != selectedLayer)
-				continue;
-			currentLayersHiSpeeds.push_back(std::pair(i, h));
+			if (!segments.empty())
+			{
+				const Segment& last = segments.back();
+				seconds += (tempo.tick - last.tick) * (60.0 / last.bpm / beatTicks);
+			}
+
+			segments.push_back({ tempo.tick, tempo.bpm, seconds });
 		}
-		std::sort(currentLayersHiSpeeds.begin(), currentLayersHiSpeeds.end(),
-		          [](const auto& a, const auto& b) { return a.second.tick < b.second.tick; });
-		for (auto it = currentLayersHiSpeeds.rbegin(); it != currentLayersHiSpeeds.rend(); ++it)
+
+		dirty = false;
+	}
+
+	const TempoMap::Segment& TempoMap::segmentAtTick(int tick) const
+	{
+		// Ticks before the first tempo change are extrapolated from the first segment
+		auto it = std::upper_bound(segments.begin(), segments.end(), tick,
+		                           [](int tick, const Segment& s) { return tick < s.tick; });
+		return it == segments.begin() ? *it : *std::prev(it);
+	}
+
+	double TempoMap::ticksToSeconds(int tick, const std::vector<Tempo>& tempos)
+	{
+		if (dirty)
+			rebuild(tempos);
+
+		if (segments.empty())
+			return 0;
+
+		const Segment& segment = segmentAtTick(tick);
+		return segment.seconds + (tick - segment.tick) * (60.0 / segment.bpm / beatTicks);
+	}
+
+	int TempoMap::secondsToTicks(double seconds, const std::vector<Tempo>& tempos)
+	{
+		if (dirty)
+			rebuild(tempos);
+
+		if (segments.empty())
+			return 0;
+
+		auto it =
+		    std::upper_bound(segments.begin(), segments.end(), seconds,
+		                     [](double seconds, const Segment& s) { return seconds < s.seconds; });
+		const Segment& segment = it == segments.begin() ? *it : *std::prev(it);
+		return segment.tick + (int)((seconds - segment.seconds) / (60.0 / segment.bpm / beatTicks));
+	}
+
+	const Tempo& TempoMap::getTempoAt(int tick, const std::vector<Tempo>& tempos)
+	{
+		if (dirty)
+			rebuild(tempos);
+
+		if (segments.empty())
+			return tempos[0];
+
+		return tempos[&segmentAtTick(tick) - segments.data()];
+	}
+
+	MeasureTable::MeasureTable(int _beatTicks)
+	    : beatTicks{ _beatTicks }, defaultSegment{ 0, 0, 4 * _beatTicks, _beatTicks }
+	{
+	}
+
+	void MeasureTable::rebuild(const std::map<int, TimeSignature>& ts)
+	{
+		segments.clear();
+		segments.reserve(ts.size());
+
+		for (const auto& [measure, signature] : ts)
 		{
-			if (it->second.tick <= tick)
-				return it->first;
+			int tick = 0;
+			if (!segments.empty())
+			{
+				const Segment& last = segments.back();
+				tick = last.tick + (measure - last.measure) * last.ticksPerMeasure;
+			}
+
+			int ticksPerMeasure = beatsPerMeasure(signature) * beatTicks;
+			segments.push_back(
+			    { measure, tick, ticksPerMeasure, ticksPerMeasure / signature.numerator });
 		}
 
-		return -1;
+		dirty = false;
 	}
 
-	const Tempo& getTempoAt(int tick, const std::vector<Tempo>& tempos)
+	int MeasureTable::ticksToMeasure(int tick, const std::map<int, TimeSignature>& ts)
 	{
-		for (auto it = tempos.rbegin(); it != tempos.rend(); ++it)
-			if (it->tick <= tick)
-				return *it;
+		if (dirty)
+			rebuild(ts);
 
-		return tempos[0];
+		if (segments.empty())
+			return 0;
+
+		auto it = std::upper_bound(segments.begin(), segments.end(), tick,
+		                           [](int tick, const Segment& s) { return tick < s.tick; });
+		const Segment& segment = it == segments.begin() ? *it : *std::prev(it);
+		return segment.measure + (tick - segment.tick) / segment.ticksPerMeasure;
+	}
+
+	int MeasureTable::measureToTicks(int measure, const std::map<int, TimeSignature>& ts)
+	{
+		const Segment& segment = segmentAtMeasure(measure, ts);
+		return segment.tick + (measure - segment.measure) * segment.ticksPerMeasure;
+	}
+
+	const MeasureTable::Segment&
+	MeasureTable::segmentAtMeasure(int measure, const std::map<int, TimeSignature>& ts)
+	{
+		if (dirty)
+			rebuild(ts);
+
+		if (segments.empty())
+			return defaultSegment;
+
+		auto it =
+		    std::upper_bound(segments.begin(), segments.end(), measure,
+		                     [](int measure, const Segment& s) { return measure < s.measure; });
+		return it == segments.begin() ? *it : *std::prev(it);
+	}
+
+	void HiSpeedTimeline::rebuild(const std::unordered_map<int, HiSpeedChange>& hiSpeeds)
+	{
+		layers.clear();
+		allLayers.clear();
+		allLayers.reserve(hiSpeeds.size());
+
+		for (const auto& [id, hiSpeed] : hiSpeeds)
+		{
+			Entry entry{ hiSpeed.tick, hiSpeed.speed, id, 0 };
+			layers[hiSpeed.layer].push_back(entry);
+			allLayers.push_back(entry);
+		}
+
+		auto sortAndAccumulate = [](std::vector<Entry>& entries)
+		{
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+			          { return a.tick == b.tick ? a.ID < b.ID : a.tick < b.tick; });
+
+			int lastTick = 0;
+			float lastSpeed = 1.0f;
+			double distance = 0;
+			for (Entry& entry : entries)
+			{
+				distance += (double)(entry.tick - lastTick) * lastSpeed;
+				entry.distance = distance;
+				lastTick = entry.tick;
+				lastSpeed = entry.speed;
+			}
+		};
+
+		for (auto& [_, entries] : layers)
+			sortAndAccumulate(entries);
+		sortAndAccumulate(allLayers);
+
+		dirty = false;
+	}
+
+	const std::vector<HiSpeedTimeline::Entry>&
+	HiSpeedTimeline::getLayer(int layer, const std::unordered_map<int, HiSpeedChange>& hiSpeeds)
+	{
+		static const std::vector<Entry> empty;
+		if (dirty)
+			rebuild(hiSpeeds);
+
+		if (layer == -1)
+			return allLayers;
+
+		auto it = layers.find(layer);
+		return it != layers.end() ? it->second : empty;
+	}
+
+	const HiSpeedTimeline::Entry*
+	HiSpeedTimeline::findEntry(int tick, int layer,
+	                           const std::unordered_map<int, HiSpeedChange>& hiSpeeds)
+	{
+		const std::vector<Entry>& entries = getLayer(layer, hiSpeeds);
+		auto it = std::upper_bound(entries.begin(), entries.end(), tick,
+		                           [](int tick, const Entry& e) { return tick < e.tick; });
+		return it == entries.begin() ? nullptr : &*std::prev(it);
+	}
+
+	int HiSpeedTimeline::findChange(int tick, int layer,
+	                                const std::unordered_map<int, HiSpeedChange>& hiSpeeds)
+	{
+		const Entry* entry = findEntry(tick, layer, hiSpeeds);
+		return entry ? entry->ID : -1;
+	}
+
+	float HiSpeedTimeline::speedAt(int tick, int layer,
+	                               const std::unordered_map<int, HiSpeedChange>& hiSpeeds)
+	{
+		const Entry* entry = findEntry(tick, layer, hiSpeeds);
+		return entry ? entry->speed : 1.0f;
+	}
+
+	double HiSpeedTimeline::distanceAt(int tick, int layer,
+	                                   const std::unordered_map<int, HiSpeedChange>& hiSpeeds)
+	{
+		const Entry* entry = findEntry(tick, layer, hiSpeeds);
+		if (!entry)
+			return tick;
+
+		return entry->distance + (double)(tick - entry->tick) * entry->speed;
 	}
 
 	int snapTick(int tick, int div)
@@ -38,6 +38,116 @@ namespace MikuMikuWorld
 
 	const Tempo& getTempoAt(int tick, const std::vector<Tempo>& tempos);
 	int findTimeSignature(int measure, const std::map<int, TimeSignature>& ts);
-	int findHighSpeedChange(int tick, const std::unordered_map<int, HiSpeedChange>& hiSpeeds,
-	                        int selectedLayer);
+
+	/**
+	 * @brief Precomputed tick <-> seconds conversion table over a sorted list of tempo changes
+	 * @note Cumulative times are kept in double precision and looked up by binary search.
+	 *       The table is rebuilt lazily on the next query after `invalidate()` is called,
+	 *       so every code path that adds, removes or edits tempo changes must invalidate it
+	 */
+	class TempoMap
+	{
+	  private:
+		struct Segment
+		{
+			int tick;
+			double bpm;
+			// Time elapsed from tick 0 to the start of this segment
+			double seconds;
+		};
+
+		std::vector<Segment> segments;
+		int beatTicks;
+		bool dirty{ true };
+
+		void rebuild(const std::vector<Tempo>& tempos);
+		const Segment& segmentAtTick(int tick) const;
+
+	  public:
+		explicit TempoMap(int beatTicks);
+
+		inline void invalidate() { dirty = true; }
+
+		double ticksToSeconds(int tick, const std::vector<Tempo>& tempos);
+		int secondsToTicks(double seconds, const std::vector<Tempo>& tempos);
+		const Tempo& getTempoAt(int tick, const std::vector<Tempo>& tempos);
+	};
+
+	/**
+	 * @brief Precomputed measure table over the time signature changes of a score
+	 * @note Like `TempoMap` it is rebuilt lazily after `invalidate()`, so every code path that
+	 *       adds, removes or edits time signatures must invalidate it
+	 */
+	class MeasureTable
+	{
+	  public:
+		struct Segment
+		{
+			// Measure of the time signature change starting this segment
+			int measure;
+			int tick;
+			int ticksPerMeasure;
+			int beatTicks;
+		};
+
+	  private:
+		std::vector<Segment> segments;
+		int beatTicks;
+		// 4/4 segment returned when the score has no time signatures
+		Segment defaultSegment;
+		bool dirty{ true };
+
+		void rebuild(const std::map<int, TimeSignature>& ts);
+
+	  public:
+		explicit MeasureTable(int beatTicks);
+
+		inline void invalidate() { dirty = true; }
+
+		int ticksToMeasure(int tick, const std::map<int, TimeSignature>& ts);
+		int measureToTicks(int measure, const std::map<int, TimeSignature>& ts);
+		// Returns the time signature segment the measure belongs to, or a 4/4 segment without any
+		const Segment& segmentAtMeasure(int measure, const std::map<int, TimeSignature>& ts);
+	};
+
+	/**
+	 * @brief Per-layer tick-sorted view of `Score::hiSpeedChanges` with the cumulative scroll
+	 *        distance at every change
+	 * @note Layer -1 refers to the changes of all layers merged together. The change active at a
+	 *       tick is the last one at or before it, ties on the same tick going to the higher ID.
+	 *       The view is rebuilt lazily after `invalidate()`
+	 */
+	class HiSpeedTimeline
+	{
+	  private:
+		struct Entry
+		{
+			int tick;
+			float speed;
+			int ID;
+			// Scroll distance in ticks travelled from tick 0 to this change
+			double distance;
+		};
+
+		std::map<int, std::vector<Entry>> layers;
+		std::vector<Entry> allLayers;
+		bool dirty{ true };
+
+		void rebuild(const std::unordered_map<int, HiSpeedChange>& hiSpeeds);
+		const std::vector<Entry>& getLayer(int layer,
+		                                   const std::unordered_map<int, HiSpeedChange>& hiSpeeds);
+		// Returns the last change at or before the tick or nullptr if there is none
+		const Entry* findEntry(int tick, int layer,
+		                       const std::unordered_map<int, HiSpeedChange>& hiSpeeds);
+
+	  public:
+		inline void invalidate() { dirty = true; }
+
+		// Returns the ID of the active hi-speed change at the tick or -1 if there is none
+		int findChange(int tick, int layer, const std::unordered_map<int, HiSpeedChange>& hiSpeeds);
+		float speedAt(int tick, int layer, const std::unordered_map<int, HiSpeedChange>& hiSpeeds);
+		// Scroll distance in ticks from tick 0 to the tick. The speed before the first change is 1
+		double distanceAt(int tick, int layer,
+		                  const std::unordered_map<int, HiSpeedChange>& hiSpeeds);
+	};
 }
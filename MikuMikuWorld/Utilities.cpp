@@ -20,6 +20,17 @@ namespace MikuMikuWorld
 		return buf;
 	}
 
+	std::string Utilities::getCurrentTime()
+	{
+		std::time_t now = std::time(0);
+		std::tm localTime = *std::localtime(&now);
+
+		char buf[16];
+		strftime(buf, 16, "%H:%M:%S", &localTime);
+
+		return buf;
+	}
+
 	std::string Utilities::getSystemLocale()
 	{
 		LPWSTR lpLocalName = new WCHAR[LOCALE_NAME_MAX_LENGTH];
@@ -48,6 +48,7 @@ namespace MikuMikuWorld
 	{
 	  public:
 		static std::string getCurrentDateTime();
+		static std::string getCurrentTime();
 		static std::string getSystemLocale();
 		static std::string getDivisionString(int div);
 		static std::vector<std::string> splitString(const std::string& base, const char delimiter);
@@ -2,21 +2,35 @@
 
 in vec2 uv1;
 in vec4 color;
+flat in uint textureSlot;
 
 out vec4 fragColor;
 
-struct Material
-{
-    sampler2D diffuse0;
-    sampler2D diffuse1;
-    float blend;
-};
-
-uniform Material material;
+// One sampler per texture unit of a sprite batch, matches maxBatchTextures in Renderer.h
+uniform sampler2D textures[8];
 uniform int blendMode;
 
+vec4 sampleTexture(vec2 uv)
+{
+    // Sampler arrays can only be indexed by constants in GLSL 3.30. The gradients are taken
+    // outside of the branch so mipmapped textures keep their filtering
+    vec2 dx = dFdx(uv);
+    vec2 dy = dFdy(uv);
+    switch (textureSlot)
+    {
+    case 0u: return textureGrad(textures[0], uv, dx, dy);
+    case 1u: return textureGrad(textures[1], uv, dx, dy);
+    case 2u: return textureGrad(textures[2], uv, dx, dy);
+    case 3u: return textureGrad(textures[3], uv, dx, dy);
+    case 4u: return textureGrad(textures[4], uv, dx, dy);
+    case 5u: return textureGrad(textures[5], uv, dx, dy);
+    case 6u: return textureGrad(textures[6], uv, dx, dy);
+    default: return textureGrad(textures[7], uv, dx, dy);
+    }
+}
+
 void main()
 {
-    vec4 texColor = texture(material.diffuse0, uv1) * color;
+    vec4 texColor = sampleTexture(uv1) * color;
     fragColor = texColor;
-}
+}
\ No newline at end of file
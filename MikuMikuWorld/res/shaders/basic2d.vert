@@ -1,11 +1,13 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
+layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec4 aColor;
 layout (location = 2) in vec2 aUV1;
+layout (location = 3) in uint aTextureSlot;
 
 out vec2 uv1;
 out vec4 color;
+flat out uint textureSlot;
 
 uniform mat4 view;
 uniform mat4 projection;
@@ -14,5 +16,6 @@ void main()
 {
     uv1         = aUV1;
     color       = aColor;
-    gl_Position = projection * vec4(aPos, 1.0);
+    textureSlot = aTextureSlot;
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "Rendering/VertexStream.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace MikuMikuWorld;
+
+// Checks the vertex data the renderer uploads against known good values, without a GPU
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+	if (condition)
+		return;
+
+	fprintf(stderr, "FAILED: %s\n", what);
+	++failures;
+}
+
+static bool vertexEquals(const Vertex& a, const Vertex& b)
+{
+	return a.x == b.x && a.y == b.y && a.u == b.u && a.v == b.v && a.color == b.color &&
+	       a.textureSlot == b.textureSlot;
+}
+
+static Quad makeQuad(float x, float y, uint32_t color, int texture)
+{
+	// order: top-right, bottom-right, bottom-left, top-left
+	return Quad{ 0,
+		         texture,
+		         { { x + 1, y + 1, 1, 0, color, 0 },
+		           { x + 1, y, 1, 1, color, 0 },
+		           { x, y, 0, 1, color, 0 },
+		           { x, y + 1, 0, 0, color, 0 } } };
+}
+
+static void testQuadIndices()
+{
+	const std::vector<uint32_t> golden = {
+		0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 8, 9, 10, 10, 11, 8,
+	};
+
+	check(VertexBatch::generateQuadIndices(3) == golden, "indices of 3 quads");
+	check(VertexBatch::generateQuadIndices(0).empty(), "indices of no quads");
+
+	VertexBatch batch(12);
+	check(batch.getIndices() == golden, "batch indices cover its capacity");
+}
+
+static void testPushedVertices()
+{
+	const Vertex golden[] = {
+		{ 11, 21, 1, 0, 0xff0000ff, 2 }, { 11, 20, 1, 1, 0xff0000ff, 2 },
+		{ 10, 20, 0, 1, 0xff0000ff, 2 }, { 10, 21, 0, 0, 0xff0000ff, 2 },
+		{ -4, 1, 1, 0, 0x80ffffff, 0 },  { -4, 0, 1, 1, 0x80ffffff, 0 },
+		{ -5, 0, 0, 1, 0x80ffffff, 0 },  { -5, 1, 0, 0, 0x80ffffff, 0 },
+	};
+
+	VertexBatch batch(8);
+	batch.push(makeQuad(10, 20, 0xff0000ff, 7), 2);
+	batch.push(makeQuad(-5, 0, 0x80ffffff, 3), 0);
+
+	check(batch.getCount() == 8, "vertex count after 2 quads");
+	check(batch.getIndexCount() == 12, "index count after 2 quads");
+	check(batch.getByteSize() == sizeof(golden), "byte size after 2 quads");
+
+	bool matches = true;
+	for (int i = 0; i < 8; ++i)
+		matches &= vertexEquals(batch.getVertices()[i], golden[i]);
+
+	check(matches, "pushed vertices");
+
+	batch.clear();
+	check(batch.getCount() == 0 && batch.getIndexCount() == 0, "cleared batch is empty");
+
+	batch.push(makeQuad(-5, 0, 0x80ffffff, 3), 0);
+	check(vertexEquals(batch.getVertices()[0], golden[4]), "push after clear starts at 0");
+}
+
+static void testStreamRing()
+{
+	StreamRing ring(100, 3);
+	check(ring.getCapacity() == 300, "ring capacity");
+	check(!ring.isRegionUsed(), "new ring is unused");
+
+	// Draws of a frame take consecutive ranges of its region
+	check(ring.allocate(40) == 0, "first draw of frame 0");
+	check(ring.allocate(40) == 40, "second draw of frame 0");
+	check(ring.allocate(40) == -1, "draw past the region");
+	check(ring.isRegionUsed(), "region used after drawing");
+
+	check(ring.advance() == 1, "frame 1 region");
+	check(!ring.isRegionUsed(), "next region starts unused");
+	check(ring.allocate(100) == 100, "full draw of frame 1");
+
+	check(ring.advance() == 2, "frame 2 region");
+	check(ring.allocate(8) == 200, "draw of frame 2");
+
+	// The 4th frame reuses the region of the 1st
+	check(ring.advance() == 0, "frame 3 wraps around");
+	check(ring.allocate(8) == 0, "draw of frame 3");
+
+	ring.reset();
+	check(ring.getRegion() == 0 && !ring.isRegionUsed(), "reset ring");
+}
+
+int main()
+{
+	testQuadIndices();
+	testPushedVertices();
+	testStreamRing();
+
+	if (failures)
+		return EXIT_FAILURE;
+
+	printf("All vertex stream tests passed\n");
+	return EXIT_SUCCESS;
+}
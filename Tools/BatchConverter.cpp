@@ -0,0 +1,356 @@
+// Converts charts between the formats supported by the editor without opening it.
+// Usage: BatchConverter [options] <file or directory>...
+#include "Constants.h"
+#include "File.h"
+#include "SUS.h"
+#include "Score.h"
+#include "ScoreConverter.h"
+#include "Sonolus_json.h"
+#include "Stopwatch.h"
+#include "SusExporter.h"
+#include "SusParser.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+using namespace MikuMikuWorld;
+namespace fs = std::filesystem;
+
+namespace
+{
+	constexpr const char* EXPORT_COMMENT =
+	    "This file was generated by MikuMikuWorld for Chart Cyanvas batch converter";
+
+	struct ConverterOptions
+	{
+		std::string format{ CC_MMWS_EXTENSION };
+		fs::path outputDirectory;
+		fs::path reportFilename;
+		size_t jobs{ std::max(std::thread::hardware_concurrency(), 1u) };
+		bool recursive{ false };
+		bool compact{ false };
+		bool minify{ false };
+		std::vector<fs::path> inputs;
+	};
+
+	struct ConversionJob
+	{
+		fs::path input;
+		fs::path output;
+		std::string error{};
+		double seconds{};
+	};
+
+	void printUsage()
+	{
+		printf("Usage: BatchConverter [options] <file or directory>...\n"
+		       "Options:\n"
+		       "  -f, --format <ext>  output format: ccmmws, mmws, usc or sus (default ccmmws)\n"
+		       "  -o, --output <dir>  output directory (default: next to each input)\n"
+		       "  -j, --jobs <n>      number of worker threads (default: one per core)\n"
+		       "  -r, --recursive     include subdirectories of input directories\n"
+		       "      --compact       write compact MMWS files\n"
+		       "      --minify        write minified USC files\n"
+		       "      --report <file> write a tab separated result for every file\n");
+	}
+
+	std::string toLower(std::string str)
+	{
+		std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+		return str;
+	}
+
+	std::string getExtension(const fs::path& path) { return toLower(path.extension().u8string()); }
+
+	bool isInputFormat(const std::string& extension)
+	{
+		return extension == SUS_EXTENSION || extension == USC_EXTENSION ||
+		       extension == MMWS_EXTENSION || extension == CC_MMWS_EXTENSION ||
+		       extension == JSON_EXTENSION;
+	}
+
+	bool isOutputFormat(const std::string& extension)
+	{
+		return extension == SUS_EXTENSION || extension == USC_EXTENSION ||
+		       extension == MMWS_EXTENSION || extension == CC_MMWS_EXTENSION;
+	}
+
+	bool parseOptions(int argc, char** argv, ConverterOptions& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+			if (arg == "-h" || arg == "--help")
+				return false;
+			else if ((arg == "-f" || arg == "--format") && hasValue)
+				options.format = "." + toLower(argv[++i]);
+			else if ((arg == "-o" || arg == "--output") && hasValue)
+				options.outputDirectory = fs::u8path(argv[++i]);
+			else if ((arg == "-j" || arg == "--jobs") && hasValue)
+				options.jobs = std::max(std::atoi(argv[++i]), 1);
+			else if (arg == "--report" && hasValue)
+				options.reportFilename = fs::u8path(argv[++i]);
+			else if (arg == "-r" || arg == "--recursive")
+				options.recursive = true;
+			else if (arg == "--compact")
+				options.compact = true;
+			else if (arg == "--minify")
+				options.minify = true;
+			else if (!arg.empty() && arg[0] == '-')
+			{
+				fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+				return false;
+			}
+			else
+				options.inputs.push_back(fs::u8path(arg));
+		}
+
+		if (!isOutputFormat(options.format))
+		{
+			fprintf(stderr, "Unsupported output format: %s\n", options.format.c_str() + 1);
+			return false;
+		}
+
+		return !options.inputs.empty();
+	}
+
+	fs::path getOutputFilename(const fs::path& input, const fs::path& relativeDirectory,
+	                           const ConverterOptions& options)
+	{
+		fs::path directory = options.outputDirectory.empty()
+		                         ? input.parent_path()
+		                         : options.outputDirectory / relativeDirectory;
+
+		fs::path filename = directory / fs::u8path(input.stem().u8string() + options.format);
+		return filename.lexically_normal();
+	}
+
+	// Lists the files to convert, keeping the layout of input directories in the output directory
+	std::vector<ConversionJob> collectJobs(const ConverterOptions& options)
+	{
+		std::vector<ConversionJob> jobs;
+		auto addFile = [&](const fs::path& file, const fs::path& relativeDirectory)
+		{
+			if (isInputFormat(getExtension(file)))
+				jobs.push_back({ file, getOutputFilename(file, relativeDirectory, options) });
+		};
+
+		for (const fs::path& input : options.inputs)
+		{
+			std::error_code error;
+			if (!fs::is_directory(input, error))
+			{
+				if (fs::exists(input, error))
+					addFile(input, {});
+				else
+					jobs.push_back({ input, {}, "File not found" });
+
+				continue;
+			}
+
+			auto addEntry = [&](const fs::directory_entry& entry)
+			{
+				if (entry.is_regular_file())
+					addFile(entry.path(), entry.path().parent_path().lexically_relative(input));
+			};
+
+			// An unreadable directory fails the run instead of silently converting nothing
+			try
+			{
+				if (options.recursive)
+					for (const auto& entry : fs::recursive_directory_iterator(input, error))
+						addEntry(entry);
+				else
+					for (const auto& entry : fs::directory_iterator(input, error))
+						addEntry(entry);
+			}
+			catch (const fs::filesystem_error& err)
+			{
+				error = err.code();
+			}
+
+			if (error)
+				jobs.push_back({ input, {}, "Failed to read the directory: " + error.message() });
+		}
+
+		// Inputs that only differ by extension would overwrite each other's output
+		std::unordered_map<std::string, const ConversionJob*> outputs;
+		for (ConversionJob& job : jobs)
+		{
+			if (!job.error.empty())
+				continue;
+
+			auto [it, inserted] = outputs.emplace(job.output.u8string(), &job);
+			if (!inserted)
+				job.error = "Output is already written by " + it->second->input.u8string();
+		}
+
+		return jobs;
+	}
+
+	Score loadScore(const fs::path& path)
+	{
+		const std::string filename = path.u8string();
+		const std::string extension = getExtension(path);
+
+		// IDs only have to be unique within a score and the counters are per thread
+		resetNextID();
+		if (extension == SUS_EXTENSION)
+		{
+			SusParser susParser;
+			return ScoreConverter::susToScore(susParser.parse(filename));
+		}
+		else if (extension == USC_EXTENSION)
+		{
+			std::unique_ptr<FILE, decltype(&fclose)> file(IO::File::openStream(filename, "r"),
+			                                              &fclose);
+			if (!file)
+				throw std::runtime_error("Failed to open the file for reading.");
+
+			return ScoreConverter::uscToScore(nlohmann::json::parse(file.get()));
+		}
+		else if (extension == MMWS_EXTENSION || extension == CC_MMWS_EXTENSION)
+		{
+			return deserializeScore(filename);
+		}
+		else if (extension == JSON_EXTENSION)
+		{
+			return Sonolus_json::load_file(filename);
+		}
+
+		throw std::runtime_error("Unsupported file format.");
+	}
+
+	void saveScore(const Score& score, const fs::path& path, const ConverterOptions& options)
+	{
+		const std::string filename = path.u8string();
+		if (options.format == SUS_EXTENSION)
+		{
+			SusExporter exporter;
+			exporter.dump(ScoreConverter::scoreToSus(score), filename, EXPORT_COMMENT);
+		}
+		else if (options.format == USC_EXTENSION)
+		{
+			const std::string usc =
+			    ScoreConverter::scoreToUsc(score).dump(options.minify ? -1 : 4);
+
+			std::unique_ptr<FILE, decltype(&fclose)> file(IO::File::openStream(filename, "w"),
+			                                              &fclose);
+			if (!file || fwrite(usc.data(), 1, usc.size(), file.get()) != usc.size())
+				throw std::runtime_error("Failed to write the file.");
+		}
+		else
+		{
+			serializeScore(score, filename, options.compact);
+		}
+	}
+
+	void convert(ConversionJob& job, const ConverterOptions& options)
+	{
+		Stopwatch stopwatch;
+		try
+		{
+			Score score = loadScore(job.input);
+
+			std::error_code error;
+			if (job.output.has_parent_path())
+				fs::create_directories(job.output.parent_path(), error);
+
+			saveScore(score, job.output, options);
+		}
+		catch (const std::exception& err)
+		{
+			job.error = err.what();
+		}
+
+		job.seconds = stopwatch.elapsed();
+	}
+
+	void writeReport(const std::vector<ConversionJob>& jobs, const fs::path& reportFilename)
+	{
+		std::unique_ptr<FILE, decltype(&fclose)> report(
+		    IO::File::openStream(reportFilename.u8string(), "w"), &fclose);
+		if (!report)
+		{
+			fprintf(stderr, "Failed to write the report to %s\n", reportFilename.u8string().c_str());
+			return;
+		}
+
+		fprintf(report.get(), "status\tinput\toutput\tms\terror\n");
+		for (const ConversionJob& job : jobs)
+		{
+			// Keep every entry on a single line
+			std::string error = job.error;
+			std::replace_if(
+			    error.begin(), error.end(), [](char c) { return c == '\n' || c == '\t'; }, ' ');
+
+			fprintf(report.get(), "%s\t%s\t%s\t%.3f\t%s\n", job.error.empty() ? "ok" : "failed",
+			        job.input.u8string().c_str(), job.output.u8string().c_str(),
+			        job.seconds * 1000.0, error.c_str());
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	ConverterOptions options;
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<ConversionJob> jobs = collectJobs(options);
+
+	Stopwatch stopwatch;
+	std::mutex outputMutex;
+	size_t finished = 0;
+	{
+		ThreadPool pool(std::min(options.jobs, std::max<size_t>(jobs.size(), 1)));
+		for (ConversionJob& job : jobs)
+		{
+			if (!job.error.empty())
+				continue;
+
+			pool.submit(
+			    [&job, &options, &outputMutex, &finished, total = jobs.size()]
+			    {
+				    convert(job, options);
+
+				    std::lock_guard lock(outputMutex);
+				    printf("[%zu/%zu] %s %s\n", ++finished, total,
+				           job.error.empty() ? "ok    " : "failed", job.input.u8string().c_str());
+			    });
+		}
+
+		pool.wait();
+	}
+
+	size_t failed = 0;
+	for (const ConversionJob& job : jobs)
+	{
+		if (job.error.empty())
+			continue;
+
+		if (failed++ == 0)
+			fprintf(stderr, "\nFailed files:\n");
+
+		fprintf(stderr, "  %s: %s\n", job.input.u8string().c_str(), job.error.c_str());
+	}
+
+	printf("\nConverted %zu of %zu files in %.2f s\n", jobs.size() - failed, jobs.size(),
+	       stopwatch.elapsed());
+
+	if (!options.reportFilename.empty())
+		writeReport(jobs, options.reportFilename);
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
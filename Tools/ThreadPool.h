@@ -0,0 +1,95 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace MikuMikuWorld
+{
+	/**
+	 * @brief Fixed number of worker threads running queued tasks in submission order
+	 * @note Tasks must not throw, exceptions should be handled inside of them
+	 */
+	class ThreadPool
+	{
+	  private:
+		std::vector<std::thread> workers;
+		std::queue<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable taskAvailable;
+		std::condition_variable tasksDone;
+		size_t runningTasks{};
+		bool stopping{ false };
+
+		void work()
+		{
+			while (true)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock lock(mutex);
+					taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+					if (tasks.empty())
+						return;
+
+					task = std::move(tasks.front());
+					tasks.pop();
+					++runningTasks;
+				}
+
+				task();
+
+				std::lock_guard lock(mutex);
+				if (--runningTasks == 0 && tasks.empty())
+					tasksDone.notify_all();
+			}
+		}
+
+	  public:
+		explicit ThreadPool(size_t threadCount)
+		{
+			threadCount = std::max<size_t>(threadCount, 1);
+			workers.reserve(threadCount);
+			for (size_t i = 0; i < threadCount; ++i)
+				workers.emplace_back(&ThreadPool::work, this);
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Runs the remaining queued tasks before joining the workers
+		~ThreadPool()
+		{
+			{
+				std::lock_guard lock(mutex);
+				stopping = true;
+			}
+
+			taskAvailable.notify_all();
+			for (std::thread& worker : workers)
+				worker.join();
+		}
+
+		size_t size() const { return workers.size(); }
+
+		void submit(std::function<void()> task)
+		{
+			{
+				std::lock_guard lock(mutex);
+				tasks.push(std::move(task));
+			}
+
+			taskAvailable.notify_one();
+		}
+
+		// Blocks until every submitted task has finished
+		void wait()
+		{
+			std::unique_lock lock(mutex);
+			tasksDone.wait(lock, [this] { return tasks.empty() && runningTasks == 0; });
+		}
+	};
+}